@@ -0,0 +1,268 @@
+#include "benchmark.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "game/compatibility/mem32.h"
+#include "game/gamescript.h"
+#include "game/gamesession.h"
+#include "game/serialize.h"
+#include "graphics/dynamic/frustrum.h"
+#include "graphics/dynamic/occlusionbuffer.h"
+#include "graphics/worldview.h"
+#include "physics/dynamicworld.h"
+#include "world/objects/npc.h"
+#include "world/world.h"
+#include "gothic.h"
+
+using namespace Tempest;
+
+Benchmark::Benchmark(uint32_t ticks, uint64_t dt)
+  :ticks(ticks), dt(std::max<uint64_t>(dt,1)) {
+  }
+
+int Benchmark::exec() {
+  if(!loadSession())
+    return -1;
+
+  Samples s;
+  s.total.reserve(ticks);
+  for(auto& i:s.stage)
+    i.reserve(ticks);
+
+  std::vector<CameraPose> path;
+  auto& gothic = Gothic::inst();
+  for(uint32_t i=0; i<ticks; ++i) {
+    waitLoading();
+    if(gothic.world()==nullptr) {
+      Log::e("benchmark: session was closed after ", i, " ticks");
+      break;
+      }
+
+    auto time0 = std::chrono::steady_clock::now();
+    gothic.tick(dt);
+    gothic.updateAnimation(dt);
+    auto time1 = std::chrono::steady_clock::now();
+
+    auto world = gothic.world();
+    if(world==nullptr)
+      continue;
+    s.total.push_back(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(time1-time0).count()));
+    for(uint8_t r=0; r<TickStats::S_Count; ++r)
+      s.stage[r].push_back(world->tickStats().time(TickStats::Stage(r)));
+    if(Gothic::options().doSoftwareOcclusion)
+      recordCameras(*world,path);
+    }
+
+  report(s);
+  if(auto world = gothic.world()) {
+    auto st  = world->pathCacheStats();
+    char buf[128] = {};
+    std::snprintf(buf,sizeof(buf),"  path cache hits: %llu, misses: %llu",
+                  static_cast<unsigned long long>(st.hits), static_cast<unsigned long long>(st.misses));
+    std::printf("%s\n",buf);
+    Log::i(buf);
+
+    auto los = world->losStats();
+    std::snprintf(buf,sizeof(buf),"  los cache hits: %llu, misses: %llu",
+                  static_cast<unsigned long long>(los.hits), static_cast<unsigned long long>(los.misses));
+    std::printf("%s\n",buf);
+    Log::i(buf);
+
+    auto& pairs = world->pairStats();
+    std::snprintf(buf,sizeof(buf),"  candidate pairs: perceptions: %llu, collision zones: %llu",
+                  static_cast<unsigned long long>(pairs.perceptions), static_cast<unsigned long long>(pairs.zones));
+    std::printf("%s\n",buf);
+    Log::i(buf);
+
+    auto& anim = world->animStats();
+    std::snprintf(buf,sizeof(buf),"  animation lod: full: %u, half: %u, quarter: %u, frozen: %u",
+                  anim.npc[ANIM_Full], anim.npc[ANIM_Half], anim.npc[ANIM_Quarter], anim.npc[ANIM_Frozen]);
+    std::printf("%s\n",buf);
+    Log::i(buf);
+
+    // ikarus-based mods only: replay recorded script memory access
+    auto mem = world->script().scriptMemory();
+    if(mem!=nullptr && !mem->trace().empty()) {
+      auto& trace = mem->trace();
+      auto  time  = Mem32::replay(trace);
+      std::snprintf(buf,sizeof(buf),"  mem32 replay: %u ops, %.3f ms, %.1f ns/op",
+                    unsigned(trace.size()), double(time)/1000000.0, double(time)/double(trace.size()));
+      std::printf("%s\n",buf);
+      Log::i(buf);
+      }
+
+    occlusionReplay(*world,path);
+    }
+  gothic.setGame(nullptr);
+  return 0;
+  }
+
+bool Benchmark::loadSession() {
+  auto& gothic = Gothic::inst();
+  std::unique_ptr<GameSession> game;
+  try {
+    if(!gothic.defaultSave().empty()) {
+      Tempest::RFile file(std::string(gothic.defaultSave()));
+      Serialize      s(file);
+      game.reset(new GameSession(s));
+      } else {
+      game.reset(new GameSession(std::string(gothic.defaultWorld())));
+      }
+    }
+  catch(const std::exception& e) {
+    Log::e("benchmark: unable to load session: ", e.what());
+    return false;
+    }
+  gothic.setGame(std::move(game));
+  return gothic.world()!=nullptr;
+  }
+
+void Benchmark::waitLoading() {
+  // world change, triggered by scripts: loading is asynchronous - finish it synchronously
+  auto& gothic = Gothic::inst();
+  while(true) {
+    auto st = gothic.checkLoading();
+    if(st==Gothic::LoadState::Idle)
+      return;
+    if(st==Gothic::LoadState::Finalize || st==Gothic::LoadState::FailedLoad) {
+      gothic.finishLoading();
+      return;
+      }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+void Benchmark::report(const Samples& s) const {
+  auto print = [](const char* name, const std::vector<uint64_t>& v) {
+    uint64_t sum = 0;
+    for(auto i:v)
+      sum += i;
+    const double avg = v.empty() ? 0.0 : double(sum)/double(v.size());
+    const double p50 = double(percentile(v,50));
+    const double p99 = double(percentile(v,99));
+    char buf[256] = {};
+    std::snprintf(buf,sizeof(buf),"  %-10s avg: %9.3f ms  p50: %9.3f ms  p99: %9.3f ms",
+                  name, avg/1000000.0, p50/1000000.0, p99/1000000.0);
+    std::printf("%s\n",buf);
+    Log::i(buf);
+    };
+
+  char hdr[128] = {};
+  std::snprintf(hdr,sizeof(hdr),"benchmark: %u ticks, dt = %u ms",
+                unsigned(s.total.size()), unsigned(dt));
+  std::printf("%s\n",hdr);
+  Log::i(hdr);
+
+  print("total", s.total);
+  for(uint8_t i=0; i<TickStats::S_Count; ++i)
+    print(TickStats::name(TickStats::Stage(i)), s.stage[i]);
+  std::fflush(stdout);
+  }
+
+void Benchmark::recordCameras(World& world, std::vector<CameraPose>& out) const {
+  const uint32_t cnt  = world.npcCount();
+  const uint32_t step = std::max(1u,cnt/CameraNpc);
+  for(uint32_t i=0; i<cnt; i+=step) {
+    auto npc = world.npcById(i);
+    if(npc==nullptr)
+      continue;
+    CameraPose p;
+    p.eye      = npc->position()+Vec3(0,EyeHeight,0);
+    p.rotation = npc->rotation();
+    out.push_back(p);
+    }
+  }
+
+void Benchmark::occlusionReplay(const World& world, const std::vector<CameraPose>& path) const {
+  auto view = world.view();
+  auto phys = world.physic();
+  if(view==nullptr || phys==nullptr || path.empty())
+    return;
+
+  auto& vis = view->visualObjects().visibility();
+  if(!vis.occluders().hasOccluders())
+    return;
+
+  // own copy: rasterization must not touch buffer of renderer
+  OcclusionBuffer     occ = vis.occluders();
+  std::vector<Bounds> obj;
+  vis.objectBounds(obj);
+
+  // same projection as Camera, with aspect of occlusion buffer
+  Matrix4x4 proj;
+  proj.perspective(Gothic::options().cameraFov, float(OcclusionBuffer::Width)/float(OcclusionBuffer::Height), 10.f, 100000.f);
+
+  // ground truth, sampled with rays: culled object is a miss, if any point of its sphere is in direct sight
+  auto inSight = [phys](const Frustrum& f, const Vec3& eye, const Bounds& b) {
+    static const Vec3 dir[] = {{0,0,0},{1,0,0},{-1,0,0},{0,1,0},{0,-1,0},{0,0,1},{0,0,-1}};
+    for(auto& d:dir) {
+      auto pt = b.midTr + d*(b.r*0.5f);
+      if(!f.testPoint(pt,0))
+        continue;
+      if(!phys->ray(eye,pt).hasCol)
+        return true;
+      }
+    return false;
+    };
+
+  const size_t views    = std::min(path.size(),size_t(MaxViews));
+  uint64_t     time     = 0;
+  uint64_t     tested   = 0;
+  uint64_t     rejected = 0;
+  uint64_t     missed   = 0;
+  for(size_t i=0; i<views; ++i) {
+    auto& p = path[i*path.size()/views];
+
+    Matrix4x4 vp = proj;
+    Matrix4x4 v;
+    v.identity();
+    v.scale(-1,-1,-1);
+    v.rotateOY(p.rotation);
+    v.translate(-p.eye);
+    vp.mul(v);
+
+    Frustrum f;
+    f.make(vp,OcclusionBuffer::Width,OcclusionBuffer::Height);
+
+    auto time0 = std::chrono::steady_clock::now();
+    occ.rasterize(f);
+    auto time1 = std::chrono::steady_clock::now();
+    time += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(time1-time0).count());
+
+    for(auto& b:obj) {
+      // frustum-only reference
+      if(!f.testPoint(b.midTr,b.r))
+        continue;
+      ++tested;
+      if(occ.isVisible(b.midTr,b.r))
+        continue;
+      ++rejected;
+      if(inSight(f,p.eye,b))
+        ++missed;
+      }
+    }
+
+  char buf[256] = {};
+  std::snprintf(buf,sizeof(buf),"  occlusion replay: %u views, raster: %.3f ms/view, in frustum: %llu, rejected: %.1f%%, in sight: %llu",
+                unsigned(views), double(time)/1000000.0/double(views),
+                static_cast<unsigned long long>(tested), tested==0 ? 0.0 : 100.0*double(rejected)/double(tested),
+                static_cast<unsigned long long>(missed));
+  std::printf("%s\n",buf);
+  Log::i(buf);
+  if(missed>0)
+    Log::e("benchmark: occlusion culling rejected ", missed, " objects in direct sight");
+  }
+
+uint64_t Benchmark::percentile(std::vector<uint64_t> v, uint32_t p) {
+  if(v.empty())
+    return 0;
+  size_t id = (v.size()-1)*p/100;
+  std::nth_element(v.begin(), v.begin()+int(id), v.end());
+  return v[id];
+  }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Tempest/Vec>
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/tickstats.h"
+
+class World;
+
+class Benchmark final {
+  public:
+    Benchmark(uint32_t ticks, uint64_t dt);
+
+    int  exec();
+
+  private:
+    struct Samples {
+      std::vector<uint64_t> total;
+      std::vector<uint64_t> stage[TickStats::S_Count];
+      };
+
+    struct CameraPose {
+      Tempest::Vec3 eye;
+      float         rotation = 0;
+      };
+
+    // npc's, whose eyes are used as camera path for occlusion replay
+    static constexpr uint32_t CameraNpc = 8;
+    static constexpr uint32_t MaxViews  = 256;
+    static constexpr float    EyeHeight = 170;
+
+    bool loadSession();
+    void waitLoading();
+    void report(const Samples& s) const;
+
+    void recordCameras  (World& world, std::vector<CameraPose>& out) const;
+    void occlusionReplay(const World& world, const std::vector<CameraPose>& path) const;
+
+    static uint64_t percentile(std::vector<uint64_t> v, uint32_t p);
+
+    uint32_t ticks = 0;
+    uint64_t dt    = 0;
+  };
@@ -2,6 +2,7 @@
 
 #include <Tempest/Log>
 #include <Tempest/TextCodec>
+#include <charconv>
 #include <cstring>
 #include <filesystem>
 #include <cassert>
@@ -104,6 +105,24 @@ CommandLine::CommandLine(int argc, const char** argv) {
       if(i<argc)
         isMeshSh = (std::string_view(argv[i])!="0" && std::string_view(argv[i])!="false");
       }
+    else if(arg=="-swocclusion") {
+      ++i;
+      if(i<argc)
+        isSwOcc = (std::string_view(argv[i])!="0" && std::string_view(argv[i])!="false");
+      }
+    else if(arg=="-headless" || arg=="--headless") {
+      headless = true;
+      }
+    else if(arg=="-ticks" || arg=="--ticks") {
+      ++i;
+      if(i<argc)
+        std::from_chars(argv[i],argv[i]+std::strlen(argv[i]),hlTicks);
+      }
+    else if(arg=="-dt" || arg=="--dt") {
+      ++i;
+      if(i<argc)
+        std::from_chars(argv[i],argv[i]+std::strlen(argv[i]),hlDt);
+      }
     }
 
   if(gpath.empty()) {
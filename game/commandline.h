@@ -34,12 +34,17 @@ class CommandLine {
     bool                isRayQuery()       const { return isRQuery;  }
     bool                isRtGi()           const { return isGi;      }
     bool                isMeshShading()    const { return isMeshSh;  }
+    bool                isSwOcclusion()    const { return isSwOcc;   }
     bool                doStartMenu()      const { return !noMenu;   }
     bool                doForceG1()        const { return forceG1;   }
     bool                doForceG2()        const { return forceG2;   }
     bool                doForceG2NR()      const { return forceG2NR; }
     std::string_view    defaultSave()      const { return saveDef;   }
 
+    bool                isHeadless()       const { return headless;  }
+    uint32_t            headlessTicks()    const { return hlTicks;   }
+    uint64_t            headlessDt()       const { return hlDt;      }
+
     std::string         wrldDef;
 
   private:
@@ -62,8 +67,13 @@ class CommandLine {
     bool                isMeshSh  = true;
 #endif
     bool                isGi      = false;
+    bool                isSwOcc   = false;
     bool                forceG1   = false;
     bool                forceG2   = false;
     bool                forceG2NR = false;
+
+    bool                headless  = false;
+    uint32_t            hlTicks   = 1000;
+    uint64_t            hlDt      = 16;
   };
 
@@ -8,6 +8,7 @@
 #include <phoenix/vobs/misc.hh>
 
 #include "game/gamescript.h"
+#include "commandline.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -73,6 +74,9 @@ const std::string& Ikarus::memory_instance::get_string(const phoenix::symbol& sy
 
 Ikarus::Ikarus(GameScript& /*owner*/, phoenix::vm& vm) : vm(vm) {
   Log::i("DMA mod detected: Ikarus");
+  // headless benchmark replays memory access of this session
+  if(CommandLine::inst().isHeadless())
+    allocator.setTraceEnabled(true);
 
   // built-in data with assumed address
   versionHint = 504628679; // G2
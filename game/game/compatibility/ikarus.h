@@ -13,6 +13,8 @@ class Ikarus : public ScriptPlugin {
 
     static bool isRequired(phoenix::script& vm);
 
+    const Mem32& memory() const { return allocator; }
+
     using ptr32_t = Mem32::ptr32_t;
 
     struct memory_instance : public phoenix::transient_instance {
@@ -4,21 +4,28 @@
 #include <cassert>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <memory>
 
 using namespace Tempest;
 
+static uint64_t alignUp(uint64_t v) {
+  return ((v+Mem32::memAlign-1)/Mem32::memAlign)*Mem32::memAlign;
+  }
+
 Mem32::Mem32() {
   /*
    *  [0x00001000 .. 0x80000000] - (2GB) user space
    *  [0x80000000 .. 0xc0000000] - (1GB) extra space(reserved for opengothic use; pinned memory)
    *  [0xc0000000 .. 0xffffffff] - (1GB) kernel space
    */
-  region.emplace_back(Region(0x1000,0x80000000));
+  addFree(0x1000,0x80000000);
   }
 
 Mem32::~Mem32() {
-  for(auto& rgn:region) {
+  for(auto& i:region) {
+    auto& rgn = i.second;
     if(rgn.status==S_Allocated && rgn.real!=nullptr) {
       std::free(rgn.real);
       rgn.real = nullptr;
@@ -27,8 +34,8 @@ Mem32::~Mem32() {
   }
 
 Mem32::ptr32_t Mem32::pin(void* mem, ptr32_t address, uint32_t size, const char* comment) {
+  record(T_PinAt,address,0,size);
   if(auto rgn = implAllocAt(address,size)) {
-    rgn->size    = size;
     rgn->real    = mem;
     rgn->status  = S_Pin;
     rgn->comment = comment;
@@ -38,8 +45,8 @@ Mem32::ptr32_t Mem32::pin(void* mem, ptr32_t address, uint32_t size, const char*
   }
 
 Mem32::ptr32_t Mem32::pin(void* mem, uint32_t size, const char* comment) {
-  if(auto rgn = implAlloc(size)) {
-    rgn->size    = size;
+  record(T_Pin,0,0,size);
+  if(auto rgn = implAlloc(std::max(size,1u))) {
     rgn->real    = mem;
     rgn->status  = S_Pin;
     rgn->comment = comment;
@@ -49,25 +56,27 @@ Mem32::ptr32_t Mem32::pin(void* mem, uint32_t size, const char* comment) {
   }
 
 Mem32::ptr32_t Mem32::alloc(ptr32_t address, uint32_t size, const char* comment) {
+  record(T_AllocAt,address,0,size);
   if(auto rgn = implAllocAt(address,size)) {
-    rgn->real = std::calloc(size,1);
+    rgn->real = std::calloc(rgn->size,1);
     if(rgn->real==nullptr) {
-      compactage();
+      release(region.find(rgn->address));
       return 0;
       }
-    rgn->size    = size;
     rgn->status  = S_Allocated;
     rgn->comment = comment;
-    return address;
+    return rgn->address;
     }
   return 0;
   }
 
 Mem32::ptr32_t Mem32::alloc(uint32_t size) {
+  record(T_Alloc,0,0,size);
+  size = uint32_t(alignUp(std::max(size,1u)));
   if(auto rgn = implAlloc(size)) {
     rgn->real = std::calloc(size,1);
     if(rgn->real==nullptr) {
-      compactage();
+      release(region.find(rgn->address));
       return 0;
       }
     rgn->status = S_Allocated;
@@ -77,35 +86,61 @@ Mem32::ptr32_t Mem32::alloc(uint32_t size) {
   }
 
 void Mem32::free(ptr32_t address) {
+  record(T_Free,address,0,0);
   if(address==0)
     return;
-  for(size_t i=0; i<region.size(); ++i) {
-    if(region[i].address!=address)
-      continue;
-    std::free(region[i].real);
-    region[i].real   = nullptr;
-    region[i].status = S_Unused;
-    compactage();
+  auto it = region.find(address);
+  if(it==region.end() || it->second.status==S_Unused) {
+    Log::e("mem_free: heap block wan't allocated by script: ", reinterpret_cast<void*>(uint64_t(address)));
     return;
     }
-  Log::e("mem_free: heap block wan't allocated by script: ", reinterpret_cast<void*>(uint64_t(address)));
+  // pinned memory is owned by engine
+  if(it->second.status==S_Allocated)
+    std::free(it->second.real);
+  release(it);
   }
 
-void Mem32::compactage() {
-  for(size_t i=0; i+1<region.size(); ) {
-    auto& a = region[i+0];
-    auto& b = region[i+1];
-    if(a.status==S_Unused && a.status==b.status && a.address+a.size==b.address) {
-      a.size += b.size;
-      b.size = 0;
-      region.erase(region.begin()+ptrdiff_t(i+1));
-      } else {
-      ++i;
-      }
+Mem32::ptr32_t Mem32::realloc(ptr32_t address, uint32_t size) {
+  record(T_Realloc,address,0,size);
+  size = uint32_t(alignUp(std::max(size,1u)));
+  if(implRealloc(address,size))
+    return address;
+
+  auto src = region.find(address);
+  if(src!=region.end() && src->second.status!=S_Allocated)
+    src = region.end();
+  if(src==region.end() && address!=0)
+    Log::e("realloc: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
+
+  auto next = implAlloc(size);
+  if(next==nullptr)
+    return 0;
+
+  void* real = nullptr;
+  if(src!=region.end()) {
+    const uint32_t prev = src->second.size;
+    real = std::realloc(src->second.real,size);
+    if(real!=nullptr && prev<size)
+      std::memset(reinterpret_cast<uint8_t*>(real)+prev,0,size-prev);
+    } else {
+    real = std::calloc(size,1);
+    }
+  if(real==nullptr) {
+    release(region.find(next->address));
+    return 0;
+    }
+
+  next->real   = real;
+  next->status = S_Allocated;
+  if(src!=region.end()) {
+    next->comment = src->second.comment;
+    release(src);
     }
+  return next->address;
   }
 
 void Mem32::writeInt(ptr32_t address, int32_t v) {
+  record(T_Write,address,0,4);
   auto rgn = translate(address);
   if(rgn==nullptr) {
     Log::e("mem_writeint: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
@@ -117,6 +152,7 @@ void Mem32::writeInt(ptr32_t address, int32_t v) {
   }
 
 int32_t Mem32::readInt(ptr32_t address) {
+  record(T_Read,address,0,4);
   auto rgn = translate(address);
   if(rgn==nullptr) {
     Log::e("mem_readint:  address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
@@ -130,6 +166,7 @@ int32_t Mem32::readInt(ptr32_t address) {
   }
 
 void Mem32::copyBytes(ptr32_t psrc, ptr32_t pdst, uint32_t size) {
+  record(T_Copy,psrc,pdst,size);
   auto src = translate(psrc);
   auto dst = translate(pdst);
   if(src==nullptr || src->status==S_Unused) {
@@ -152,145 +189,214 @@ void Mem32::copyBytes(ptr32_t psrc, ptr32_t pdst, uint32_t size) {
     Log::e("mem_copybytes: copy-size exceed destination block size: ", size);
     sz = std::min(dst->size-dOff,sz);
     }
-  std::memcpy(reinterpret_cast<uint8_t*>(dst->real)+sOff,
-              reinterpret_cast<uint8_t*>(src->real)+dOff,
-              sz);
+  std::memmove(reinterpret_cast<uint8_t*>(dst->real)+dOff,
+               reinterpret_cast<uint8_t*>(src->real)+sOff,
+               sz);
   }
 
-Mem32::Region* Mem32::implAlloc(uint32_t size) {
-  size = ((size+memAlign-1)/memAlign)*memAlign;
+void Mem32::setTraceEnabled(bool e) {
+  traceEnabled = e;
+  if(e)
+    traceLog.clear();
+  }
 
-  for(size_t i=0; i<region.size(); ++i) {
-    if(region[i].status!=S_Unused || region[i].size<size)
-      continue;
-    if(size!=region[i].size) {
-      auto p2 = region[i];
-      p2.address+=size;
-      p2.size   -=size;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
+void Mem32::record(TraceOp op, ptr32_t address, ptr32_t dest, uint32_t size) {
+  if(!traceEnabled || traceLog.size()>=MaxTrace)
+    return;
+  TraceRecord r;
+  r.op      = op;
+  r.address = address;
+  r.dest    = dest;
+  r.size    = size;
+  traceLog.push_back(r);
+  }
+
+uint64_t Mem32::replay(const std::vector<TraceRecord>& trace) {
+  // allocator is deterministic: same sequence of calls yields same addresses
+  Mem32                                   mem;
+  std::vector<std::unique_ptr<uint8_t[]>> pinned;
+  uint32_t                                sum = 0;
+
+  auto time0 = std::chrono::steady_clock::now();
+  for(auto& i:trace) {
+    switch(i.op) {
+      case T_Pin:
+      case T_PinAt: {
+        pinned.emplace_back(new uint8_t[std::max(i.size,1u)]());
+        if(i.op==T_Pin)
+          mem.pin(pinned.back().get(),i.size);
+        else
+          mem.pin(pinned.back().get(),i.address,i.size);
+        break;
+        }
+      case T_Alloc:
+        mem.alloc(i.size);
+        break;
+      case T_AllocAt:
+        mem.alloc(i.address,i.size);
+        break;
+      case T_Free:
+        mem.free(i.address);
+        break;
+      case T_Realloc:
+        mem.realloc(i.address,i.size);
+        break;
+      case T_Read:
+        sum += uint32_t(mem.readInt(i.address));
+        break;
+      case T_Write:
+        mem.writeInt(i.address,int32_t(sum));
+        break;
+      case T_Copy:
+        mem.copyBytes(i.address,i.dest,i.size);
+        break;
       }
-    region[i].size = size;
-    return &region[i];
     }
-
-  return nullptr;
+  auto time1 = std::chrono::steady_clock::now();
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(time1-time0).count());
   }
 
-Mem32::ptr32_t Mem32::realloc(ptr32_t address, uint32_t size) {
-  size = ((size+memAlign-1)/memAlign)*memAlign;
-  if(implRealloc(address,size))
-    return address;
-
-  auto next = implAlloc(size);
-  if(next==nullptr)
-    return 0;
-
-  auto src = translate(address);
-  if(src==nullptr) {
-    if(address!=0)
-      Log::e("realloc: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
-    return next->address;
+Mem32::Region* Mem32::implAlloc(uint32_t size) {
+  // best fit; unaligned head of a block is left unused
+  for(auto i=freeBySize.lower_bound({size,0}); i!=freeBySize.end(); ++i) {
+    const uint64_t at = alignUp(i->second);
+    if(at+size>uint64_t(i->second)+i->first)
+      continue;
+    return carve(region.find(i->second),ptr32_t(at),size);
     }
-
-  next->status  = S_Allocated;
-  next->real    = src->real;
-  next->comment = src->comment;
-
-  src->real     = nullptr;
-  src->status   = S_Unused;
-
-  auto ret = next->address;
-  compactage();
-  return ret;
+  return nullptr;
   }
 
 Mem32::Region* Mem32::implAllocAt(ptr32_t address, uint32_t size) {
-  for(size_t i=0; i<region.size(); ++i) {
-    auto& rgn = region[i];
-
-    if(address!=0) {
-      if(!(rgn.address<=address && address+size<=rgn.address+rgn.size))
-        continue;
-      } else {
-      if(rgn.size<size)
-        continue;
-      }
-
-    if(rgn.status!=S_Unused) {
-      Log::e("failed to pin a ",size," bytes of memory: block is in use");
-      return 0;
-      }
-
-    if(address==0)
-      address = region[i].address;
-
-    if(region[i].address<address) {
-      uint32_t off = (address-region[i].address);
-      auto p2 = region[i];
-      p2.address+=off;
-      p2.size   -=off;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
-      region[i].size = off;
-      ++i;
-      }
-    if(size!=region[i].size) {
-      auto p2 = region[i];
-      p2.address+=size;
-      p2.size   -=size;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
-      }
+  size = std::max(size,1u);
+  if(address==0) {
+    auto i = freeBySize.lower_bound({size,0});
+    if(i==freeBySize.end())
+      return nullptr;
+    return carve(region.find(i->second),i->second,size);
+    }
 
-    return &region[i];
+  auto it = region.upper_bound(address);
+  if(it==region.begin())
+    return nullptr;
+  --it;
+  auto& rgn = it->second;
+  if(uint64_t(address)+size>uint64_t(rgn.address)+rgn.size)
+    return nullptr;
+  if(rgn.status!=S_Unused) {
+    Log::e("failed to pin a ",size," bytes of memory: block is in use");
+    return nullptr;
     }
-  return nullptr;
+  return carve(it,address,size);
   }
 
 bool Mem32::implRealloc(ptr32_t address, uint32_t nsize) {
   // NOTE: in place only
-  for(size_t i=0; i<region.size(); ++i) {
-    auto& rgn = region[i];
-    if(rgn.address!=address)
-      continue;
-
-    if(nsize==rgn.size)
-      return true;
+  auto it = region.find(address);
+  if(it==region.end() || it->second.status!=S_Allocated)
+    return false;
 
-    if(nsize<rgn.size) {
-      if(auto next = std::realloc(rgn.real, nsize))
-        rgn.real = next;
-      Region frgn(address+nsize, rgn.size-nsize);
-      rgn.size = nsize;
-      region.insert(region.begin() + intptr_t(i + 1), frgn);
-      return true;
+  auto& rgn = it->second;
+  if(nsize==rgn.size)
+    return true;
+
+  auto next = std::next(it);
+  if(nsize<rgn.size) {
+    if(auto real = std::realloc(rgn.real, nsize))
+      rgn.real = real;
+    ptr32_t  tail = address+nsize;
+    uint32_t tsz  = rgn.size-nsize;
+    rgn.size = nsize;
+    if(next!=region.end() && next->second.status==S_Unused && next->first==tail+tsz) {
+      tsz += next->second.size;
+      freeBySize.erase({next->second.size,next->first});
+      region.erase(next);
       }
+    addFree(tail,tsz);
+    return true;
+    }
 
-    if(i+1==region.size())
-      return false; // can't expand
-
-    auto& rgn2 = region[i+1];
-    if(rgn2.status==S_Unused && rgn.size + rgn2.size>=nsize) {
-      auto next = std::realloc(rgn.real, nsize);
-      if(next==nullptr)
-        return false;
-      rgn2.address += (nsize-rgn.size);
-      rgn2.size    -= (nsize-rgn.size);
-      rgn.real      = next;
-      rgn.size      = nsize;
-      if(rgn2.size==0)
-        compactage();
-      return true;
-      }
+  if(next==region.end() || next->second.status!=S_Unused)
+    return false; // can't expand
+  if(next->first!=uint64_t(address)+rgn.size || uint64_t(rgn.size)+next->second.size<nsize)
+    return false;
 
+  auto real = std::realloc(rgn.real, nsize);
+  if(real==nullptr)
     return false;
-    }
-  return false;
+  std::memset(reinterpret_cast<uint8_t*>(real)+rgn.size,0,nsize-rgn.size);
+
+  const uint64_t end = uint64_t(next->first)+next->second.size;
+  freeBySize.erase({next->second.size,next->first});
+  region.erase(next);
+  if(end>uint64_t(address)+nsize)
+    addFree(address+nsize,uint32_t(end-address-nsize));
+  rgn.real = real;
+  rgn.size = nsize;
+  return true;
   }
 
 Mem32::Region* Mem32::translate(ptr32_t address) {
-  // TODO: binary-search
-  for(auto& rgn:region) {
-    if(rgn.address<=address && address<rgn.address+rgn.size && rgn.status!=S_Unused)
-      return &rgn;
+  // scripts tend to access same block many times in a row
+  if(lastHit!=nullptr && lastHit->address<=address && address-lastHit->address<lastHit->size)
+    return lastHit;
+
+  auto it = region.upper_bound(address);
+  if(it==region.begin())
+    return nullptr;
+  --it;
+  auto& rgn = it->second;
+  if(rgn.status==S_Unused || address-rgn.address>=rgn.size)
+    return nullptr;
+  lastHit = &rgn;
+  return &rgn;
+  }
+
+Mem32::Region* Mem32::carve(Iterator it, ptr32_t address, uint32_t size) {
+  // split unused region into [head] [address, size] [tail]
+  const Region   rgn = it->second;
+  const uint64_t end = uint64_t(address)+size;
+  const uint64_t rgnEnd = uint64_t(rgn.address)+rgn.size;
+  assert(rgn.status==S_Unused && rgn.address<=address && end<=rgnEnd);
+
+  freeBySize.erase({rgn.size,rgn.address});
+  region.erase(it);
+  if(rgn.address<address)
+    addFree(rgn.address,address-rgn.address);
+  if(end<rgnEnd)
+    addFree(ptr32_t(end),uint32_t(rgnEnd-end));
+
+  auto ins = region.emplace(address,Region(address,size));
+  return &ins.first->second;
+  }
+
+void Mem32::release(Iterator it) {
+  // mark region as unused and merge it with unused neighbours
+  if(&it->second==lastHit)
+    lastHit = nullptr;
+
+  ptr32_t  address = it->first;
+  uint64_t end     = uint64_t(address)+it->second.size;
+
+  auto next = std::next(it);
+  if(next!=region.end() && next->second.status==S_Unused && next->first==end) {
+    end += next->second.size;
+    freeBySize.erase({next->second.size,next->first});
+    region.erase(next);
     }
-  return nullptr;
+  if(it!=region.begin()) {
+    auto prev = std::prev(it);
+    if(prev->second.status==S_Unused && uint64_t(prev->first)+prev->second.size==address) {
+      address = prev->first;
+      freeBySize.erase({prev->second.size,prev->first});
+      region.erase(prev);
+      }
+    }
+  region.erase(it);
+  addFree(address,uint32_t(end-address));
+  }
+
+void Mem32::addFree(ptr32_t address, uint32_t size) {
+  region.emplace(address,Region(address,size));
+  freeBySize.emplace(size,address);
   }
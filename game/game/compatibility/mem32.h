@@ -1,8 +1,10 @@
 #pragma once
 
-#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
 #include <vector>
-#include <memory>
 
 class Mem32 {
   public:
@@ -12,6 +14,25 @@ class Mem32 {
     using                     ptr32_t  = uint32_t;
     static constexpr uint32_t memAlign = 8;
 
+    enum TraceOp : uint8_t {
+      T_Pin,
+      T_PinAt,
+      T_Alloc,
+      T_AllocAt,
+      T_Free,
+      T_Realloc,
+      T_Read,
+      T_Write,
+      T_Copy,
+      };
+
+    struct TraceRecord {
+      TraceOp  op      = T_Read;
+      ptr32_t  address = 0;
+      ptr32_t  dest    = 0; // copy only
+      uint32_t size    = 0;
+      };
+
     ptr32_t pin  (void* mem, ptr32_t address, uint32_t size, const char* comment = nullptr);
     ptr32_t pin  (void* mem, uint32_t size, const char* comment = nullptr);
 
@@ -26,7 +47,15 @@ class Mem32 {
     int32_t readInt  (ptr32_t address);
     void    copyBytes(ptr32_t src, ptr32_t dst, uint32_t size);
 
+    // records calls, to replay them later in benchmark
+    void    setTraceEnabled(bool e);
+    auto    trace() const -> const std::vector<TraceRecord>& { return traceLog; }
+    // executes trace against empty memory; returns time in nanoseconds
+    static uint64_t replay(const std::vector<TraceRecord>& trace);
+
   private:
+    static constexpr size_t MaxTrace = 1 << 21;
+
     enum Status:uint8_t {
       S_Unused,
       S_Allocated,
@@ -34,10 +63,9 @@ class Mem32 {
       };
 
     struct Region {
-      Region();
+      Region() = default;
       Region(ptr32_t b, uint32_t sz):address(b),size(sz){}
 
-      //std::function<void(ptr32_t offset)> callback;
       ptr32_t                             address = 0;
       uint32_t                            size    = 0;
       void*                               real    = nullptr;
@@ -45,12 +73,24 @@ class Mem32 {
       Status                              status  = S_Unused;
       };
 
+    using Iterator = std::map<ptr32_t,Region>::iterator;
+
     Region*  implAlloc(uint32_t size);
     Region*  implAllocAt(ptr32_t address, uint32_t size);
     bool     implRealloc(ptr32_t address, uint32_t size);
     Region*  translate(ptr32_t address);
-    void     compactage();
 
-    std::vector<Region> region;
-  };
+    Region*  carve(Iterator it, ptr32_t address, uint32_t size);
+    void     release(Iterator it);
+    void     addFree(ptr32_t address, uint32_t size);
+    void     record(TraceOp op, ptr32_t address, ptr32_t dest, uint32_t size);
 
+    // all regions, including unused, sorted by address
+    std::map<ptr32_t,Region>              region;
+    // unused regions, ordered by (size, address) - best fit
+    std::set<std::pair<uint32_t,ptr32_t>> freeBySize;
+    Region*                               lastHit = nullptr;
+
+    bool                                  traceEnabled = false;
+    std::vector<TraceRecord>              traceLog;
+  };
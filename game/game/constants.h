@@ -449,6 +449,14 @@ inline const char* MaterialGroupNames[] = {
   "SNOW",
   };
 
+enum AnimLod : uint8_t {
+  ANIM_Full    = 0, // sampled every frame
+  ANIM_Half    = 1, // sampled every 2nd frame
+  ANIM_Quarter = 2, // sampled every 4th frame
+  ANIM_Frozen  = 3, // off-screen: local pose is not sampled
+  ANIM_Count
+  };
+
 enum AiStateCode : int32_t {
   LOOP_CONTINUE = 0,
   LOOP_END      = 1,
@@ -4,6 +4,7 @@
 #include <Tempest/SoundEffect>
 
 #include <fstream>
+#include <bit>
 #include <cctype>
 
 #include "game/definitions/spelldefinitions.h"
@@ -61,6 +62,32 @@ bool GameScript::GlobalOutput::isFinished() {
   }
 
 
+const char* GameScript::cachedSymbolName(CachedSymbol s) {
+  switch(s) {
+    case SYM_CanNotUse:               return "G_CanNotUse";
+    case SYM_CanNotCast:              return "G_CanNotCast";
+    case SYM_TradeNotEnoughGold:      return "player_trade_not_enough_gold";
+    case SYM_MobMissingItem:          return "player_mob_missing_item";
+    case SYM_MobMissingKey:           return "player_mob_missing_key";
+    case SYM_MobAnotherIsUsing:       return "player_mob_another_is_using";
+    case SYM_MobMissingKeyOrLockpick: return "player_mob_missing_key_or_lockpick";
+    case SYM_MobMissingLockpick:      return "player_mob_missing_lockpick";
+    case SYM_MobTooFar:               return "player_mob_too_far_away";
+    case SYM_PlunderIsEmpty:          return "player_plunder_is_empty";
+    case SYM_ProcessMana:             return "Spell_ProcessMana";
+    case SYM_ProcessManaRelease:      return "Spell_ProcessMana_Release";
+    case SYM_PickLock:                return "G_PickLock";
+    case SYM_CanNpcCollideWithSpell:  return "C_CanNpcCollideWithSpell";
+    case SYM_HotkeyScreenMap:         return "player_hotkey_screen_map";
+    case SYM_HotkeyLamePotion:        return "player_hotkey_lame_potion";
+    case SYM_HotkeyLameHeal:          return "player_hotkey_lame_heal";
+    case SYM_PercAssessMagic:         return "PLAYER_PERC_ASSESSMAGIC";
+    case SYM_DamDiveTime:             return "NPC_DAM_DIVE_TIME";
+    case SYM_Count:                   break;
+    }
+  return "";
+  }
+
 GameScript::GameScript(GameSession &owner)
     :owner(owner), vm(createVm(Gothic::inst())) {
   if (vm.global_self() == nullptr || vm.global_other() == nullptr || vm.global_item() == nullptr ||
@@ -304,6 +331,9 @@ void GameScript::initCommon() {
   ZS_Attack            = aiState(findSymbolIndex("ZS_Attack")).funcIni;
   ZS_MM_Attack         = aiState(findSymbolIndex("ZS_MM_Attack")).funcIni;
 
+  for(uint8_t i=0; i<SYM_Count; ++i)
+    cachedSymbol(CachedSymbol(i));
+
   spellFxInstanceNames = vm.find_symbol_by_name("spellFxInstanceNames");
   spellFxAniLetters    = vm.find_symbol_by_name("spellFxAniLetters");
 
@@ -412,8 +442,13 @@ void GameScript::initDialogs() {
   loadDialogOU();
 
   dialogsInfo.clear();
+  dialogsByNpc.clear();
+  dialogsId.assign(vm.symbols().size(),uint32_t(-1));
   vm.enumerate_instances_by_class_name("C_INFO", [this](phoenix::symbol& sym){
+    const uint32_t id = uint32_t(dialogsInfo.size());
     dialogsInfo.push_back(vm.init_instance<phoenix::c_info>(&sym));
+    dialogsId[sym.index()] = id;
+    dialogsByNpc[dialogsInfo.back()->npc].push_back(id);
     });
   }
 
@@ -473,7 +508,7 @@ void GameScript::initializeInstanceNpc(const std::shared_ptr<phoenix::c_npc>& np
     auto* daily_routine = vm.find_symbol_by_index(uint32_t(npc->daily_routine));
 
     if(daily_routine != nullptr) {
-      vm.call_function(daily_routine);
+      callFunction(daily_routine);
       }
     }
   }
@@ -491,9 +526,17 @@ void GameScript::initializeInstanceItem(const std::shared_ptr<phoenix::c_item>&
 
 void GameScript::saveQuests(Serialize &fout) {
   quests.save(fout);
-  fout.write(uint32_t(dlgKnownInfos.size()));
+  uint32_t sz = 0;
   for(auto& i:dlgKnownInfos)
-    fout.write(uint32_t(i.first),uint32_t(i.second));
+    for(auto bits:i.second)
+      sz += uint32_t(std::popcount(bits));
+  fout.write(sz);
+  for(auto& i:dlgKnownInfos) {
+    for(uint32_t id=0; id<i.second.size()*64; ++id) {
+      if((i.second[id/64] >> (id%64)) & 1)
+        fout.write(uint32_t(i.first),uint32_t(dialogsInfo[id]->symbol_index()));
+      }
+    }
 
   fout.write(gilAttitudes);
   }
@@ -505,7 +548,7 @@ void GameScript::loadQuests(Serialize& fin) {
   for(size_t i=0;i<sz;++i){
     uint32_t f=0,s=0;
     fin.read(f,s);
-    dlgKnownInfos.insert(std::make_pair(f,s));
+    setInfoKnown(f,dialogId(s));
     }
 
   fin.read(gilAttitudes);
@@ -762,6 +805,26 @@ size_t GameScript::findSymbolIndex(std::string_view name) {
   return sym == nullptr ? size_t(-1) : sym->index();
   }
 
+phoenix::symbol* GameScript::cachedSymbol(CachedSymbol s) {
+  // resolved in initCommon; lazy for calls, that may happen before it
+  if(!symCache[s].resolved) {
+    symCache[s].sym      = vm.find_symbol_by_name(cachedSymbolName(s));
+    symCache[s].resolved = true;
+    }
+  return symCache[s].sym;
+  }
+
+ScriptFn GameScript::findFunction(std::string_view name) {
+  auto i = fnByName.find(name);
+  if(i!=fnByName.end())
+    return i->second;
+  // misses are cached too: mobsi probe state-functions, that often don't exist
+  auto*    sym = vm.find_symbol_by_name(name);
+  ScriptFn fn  = sym!=nullptr ? ScriptFn(sym->index()) : ScriptFn();
+  fnByName.emplace(std::string(name),fn);
+  return fn;
+  }
+
 size_t GameScript::symbolsCount() const {
   return vm.symbols().size();
   }
@@ -791,21 +854,19 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<pho
                                                                bool includeImp) {
   ScopeVar self (*vm.global_self(),  hnpc);
   ScopeVar other(*vm.global_other(), player);
-  std::vector<phoenix::c_info*> hDialog;
-  for(auto& info : dialogsInfo) {
-    if(info->npc==static_cast<int>(hnpc->symbol_index())) {
-      hDialog.push_back(info.get());
-      }
-    }
+  auto hDialog = dialogsOf(*hnpc);
 
   std::vector<DlgChoice> choice;
+  if(hDialog==nullptr)
+    return choice;
 
   for(int important=includeImp ? 1 : 0;important>=0;--important){
-    for(auto& i:hDialog) {
+    for(auto id:*hDialog) {
+      auto&                  i    = dialogsInfo[id];
       const phoenix::c_info& info = *i;
       if(info.important!=important)
         continue;
-      bool npcKnowsInfo = doesNpcKnowInfo(*player,vm.find_symbol_by_instance(info)->index());
+      bool npcKnowsInfo = isInfoKnown(*player,id);
       if(npcKnowsInfo && !info.permanent)
         continue;
 
@@ -824,7 +885,7 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<pho
       if(info.condition) {
         auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info.condition));
         if (conditionSymbol != nullptr) {
-          valid = vm.call_function<int>(conditionSymbol) != 0;
+          valid = callFunction<int>(conditionSymbol) != 0;
           }
         }
       if(!valid)
@@ -833,7 +894,7 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<pho
       DlgChoice ch;
       ch.title    = info.description;
       ch.scriptFn = uint32_t(info.information);
-      ch.handle   = i;
+      ch.handle   = i.get();
       ch.isTrade  = info.trade!=0;
       ch.sort     = info.nr;
       choice.emplace_back(std::move(ch));
@@ -890,91 +951,91 @@ void GameScript::exec(const GameScript::DlgChoice &dlg, Npc& player, Npc& npc) {
         ++i;
       }
     }
-  vm.call_function(vm.find_symbol_by_index(dlg.scriptFn));
+  callFunction(vm.find_symbol_by_index(dlg.scriptFn));
   }
 
 void GameScript::printCannotUseError(Npc& npc, int32_t atr, int32_t nValue) {
-  auto id = vm.find_symbol_by_name("G_CanNotUse");
+  auto id = cachedSymbol(SYM_CanNotUse);
   if(id==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id, npc.isPlayer(), atr, nValue);
+  callFunction<void>(id, npc.isPlayer(), atr, nValue);
   }
 
 void GameScript::printCannotCastError(Npc &npc, int32_t plM, int32_t itM) {
-  auto id = vm.find_symbol_by_name("G_CanNotCast");
+  auto id = cachedSymbol(SYM_CanNotCast);
   if(id==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id, npc.isPlayer(), itM, plM);
+  callFunction<void>(id, npc.isPlayer(), itM, plM);
   }
 
 void GameScript::printCannotBuyError(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_trade_not_enough_gold");
+  auto id = cachedSymbol(SYM_TradeNotEnoughGold);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingItem(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_item");
+  auto id = cachedSymbol(SYM_MobMissingItem);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingKey(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_key");
+  auto id = cachedSymbol(SYM_MobMissingKey);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobAnotherIsUsing(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_mob_another_is_using");
+  auto id = cachedSymbol(SYM_MobAnotherIsUsing);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingKeyOrLockpick(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_key_or_lockpick");
+  auto id = cachedSymbol(SYM_MobMissingKeyOrLockpick);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingLockpick(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_lockpick");
+  auto id = cachedSymbol(SYM_MobMissingLockpick);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobTooFar(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_too_far_away");
+  auto id = cachedSymbol(SYM_MobTooFar);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::invokeState(const std::shared_ptr<phoenix::c_npc>& hnpc, const std::shared_ptr<phoenix::c_npc>& oth, const char *name) {
-  auto id = vm.find_symbol_by_name(name);
+  auto id = findSymbol(findFunction(name).ptr);
   if(id==nullptr)
     return;
 
   ScopeVar self (*vm.global_self(),  hnpc);
   ScopeVar other(*vm.global_other(), oth);
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 int GameScript::invokeState(Npc* npc, Npc* oth, Npc* vic, ScriptFn fn) {
@@ -1000,10 +1061,10 @@ int GameScript::invokeState(Npc* npc, Npc* oth, Npc* vic, ScriptFn fn) {
   auto* sym = vm.find_symbol_by_index(uint32_t(fn.ptr));
   int   ret = 0;
   if(sym!=nullptr && sym->rtype() == phoenix::datatype::integer) {
-    ret = vm.call_function<int>(sym);
+    ret = callFunction<int>(sym);
     }
   else if(sym!=nullptr) {
-    vm.call_function<void>(sym);
+    callFunction<void>(sym);
     ret = 0;
     }
 
@@ -1026,35 +1087,35 @@ void GameScript::invokeItem(Npc *npc, ScriptFn fn) {
     return;
 
   ScopeVar self(*vm.global_self(), npc->handlePtr());
-  vm.call_function<void>(functionSymbol);
+  callFunction<void>(functionSymbol);
   }
 
 int GameScript::invokeMana(Npc &npc, Npc* target, int mana) {
-  auto fn = vm.find_symbol_by_name("Spell_ProcessMana");
+  auto fn = cachedSymbol(SYM_ProcessMana);
   if(fn==nullptr)
     return SpellCode::SPL_SENDSTOP;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), target != nullptr ? target->handlePtr() : nullptr);
 
-  return vm.call_function<int>(fn,mana);
+  return callFunction<int>(fn,mana);
   }
 
 int GameScript::invokeManaRelease(Npc &npc, Npc* target, int mana) {
-  auto fn = vm.find_symbol_by_name("Spell_ProcessMana_Release");
+  auto fn = cachedSymbol(SYM_ProcessManaRelease);
   if(fn==nullptr)
     return SpellCode::SPL_SENDSTOP;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), target != nullptr ? target->handlePtr() : nullptr);
 
-  return vm.call_function<int>(fn,mana);
+  return callFunction<int>(fn,mana);
   }
 
 void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
   auto&      tag = spellFxInstanceNames->get_string(size_t(it.spellId()));
   string_frm name("Spell_Cast_",tag);
-  auto       fn = vm.find_symbol_by_name(name);
+  auto       fn = findSymbol(findFunction(name).ptr);
   if(fn==nullptr)
     return;
 
@@ -1065,9 +1126,9 @@ void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
   try {
     if(fn->count()==1) {
       // this is a leveled spell
-      vm.call_function<void>(fn, splLevel);
+      callFunction<void>(fn, splLevel);
       } else {
-      vm.call_function<void>(fn);
+      callFunction<void>(fn);
       }
     }
   catch(...) {
@@ -1076,40 +1137,40 @@ void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
   }
 
 int GameScript::invokeCond(Npc& npc, std::string_view func) {
-  auto fn = vm.find_symbol_by_name(func);
+  auto fn = findSymbol(findFunction(func).ptr);
   if(fn==nullptr) {
     Gothic::inst().onPrint("MOBSI::conditionFunc is not invalid");
     return 1;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  return vm.call_function<int>(fn);
+  return callFunction<int>(fn);
   }
 
 void GameScript::invokePickLock(Npc& npc, int bSuccess, int bBrokenOpen) {
-  auto fn   = vm.find_symbol_by_name("G_PickLock");
+  auto fn   = cachedSymbol(SYM_PickLock);
   if(fn==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(fn, bSuccess, bBrokenOpen);
+  callFunction<void>(fn, bSuccess, bBrokenOpen);
   }
 
 CollideMask GameScript::canNpcCollideWithSpell(Npc& npc, Npc* shooter, int32_t spellId) {
-  auto fn   = vm.find_symbol_by_name("C_CanNpcCollideWithSpell");
+  auto fn   = cachedSymbol(SYM_CanNpcCollideWithSpell);
   if(fn==nullptr)
     return COLL_DOEVERYTHING;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), shooter->handlePtr());
-  return CollideMask(vm.call_function<int>(fn, spellId));
+  return CollideMask(callFunction<int>(fn, spellId));
   }
 
 int GameScript::playerHotKeyScreenMap(Npc& pl) {
-  auto fn   = vm.find_symbol_by_name("player_hotkey_screen_map");
+  auto fn   = cachedSymbol(SYM_HotkeyScreenMap);
   if(fn==nullptr)
     return -1;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  int map = vm.call_function<int>(fn);
+  int map = callFunction<int>(fn);
   if(map>=0)
     pl.useItem(size_t(map));
   return map;
@@ -1120,12 +1181,12 @@ void GameScript::playerHotLamePotion(Npc& pl) {
   if(opt==0)
     return;
 
-  auto fn   = vm.find_symbol_by_name("player_hotkey_lame_potion");
+  auto fn   = cachedSymbol(SYM_HotkeyLamePotion);
   if(fn==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  vm.call_function<void>(fn);
+  callFunction<void>(fn);
   }
 
 void GameScript::playerHotLameHeal(Npc& pl) {
@@ -1133,12 +1194,12 @@ void GameScript::playerHotLameHeal(Npc& pl) {
   if(opt==0)
     return;
 
-  auto fn   = vm.find_symbol_by_name("player_hotkey_lame_heal");
+  auto fn   = cachedSymbol(SYM_HotkeyLameHeal);
   if(fn==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  vm.call_function<void>(fn);
+  callFunction<void>(fn);
   }
 
 std::string_view GameScript::spellCastAnim(Npc&, Item &it) {
@@ -1219,21 +1280,21 @@ uint32_t GameScript::messageTime(std::string_view id) const {
   }
 
 void GameScript::printNothingToGet() {
-  auto id = vm.find_symbol_by_name("player_plunder_is_empty");
+  auto id = cachedSymbol(SYM_PlunderIsEmpty);
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), owner.player()->handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::useInteractive(const std::shared_ptr<phoenix::c_npc>& hnpc, std::string_view func) {
-  auto fn = vm.find_symbol_by_name(func);
+  auto fn = findSymbol(findFunction(func).ptr);
   if(fn == nullptr)
     return;
 
   ScopeVar self(*vm.global_self(),hnpc);
   try {
-    vm.call_function<void>(fn);
+    callFunction<void>(fn);
     }
   catch (...) {
     Log::i("unable to use interactive [",func,"]");
@@ -1319,10 +1380,30 @@ bool GameScript::hasSymbolName(std::string_view name) {
   return vm.find_symbol_by_name(name)!=nullptr;
   }
 
+void GameScript::runFunction(std::string_view fname) {
+  auto sym = vm.find_symbol_by_name(fname);
+  if(sym==nullptr)
+    throw std::runtime_error(std::string("script function not found: ")+std::string(fname));
+  callFunction(sym);
+  }
+
+void GameScript::runMenuFunction(phoenix::vm& menuVm, phoenix::symbol* sym) {
+  // menu.dat has own symbol table
+  ScriptProfiler::Scope scope(prof,ScriptProfiler::K_Menu,sym->index(),sym->name());
+  menuVm.call_function(sym);
+  }
+
 uint64_t GameScript::tickCount() const {
   return owner.tickCount();
   }
 
+const Mem32* GameScript::scriptMemory() const {
+  for(auto& i:plugins)
+    if(auto ik = dynamic_cast<const Ikarus*>(i.get()))
+      return &ik->memory();
+  return nullptr;
+  }
+
 void GameScript::tick(uint64_t dt) {
   for(auto& i:plugins)
     i->tick(dt);
@@ -1442,7 +1523,7 @@ AiOuputPipe *GameScript::openDlgOuput(Npc &player, Npc &npc) {
   }
 
 ScriptFn GameScript::playerPercAssessMagic() {
-  auto id = vm.find_symbol_by_name("PLAYER_PERC_ASSESSMAGIC");
+  auto id = cachedSymbol(SYM_PercAssessMagic);
   if(id==nullptr)
     return ScriptFn();
 
@@ -1452,7 +1533,7 @@ ScriptFn GameScript::playerPercAssessMagic() {
   }
 
 int GameScript::npcDamDiveTime() {
-  auto id = vm.find_symbol_by_name("NPC_DAM_DIVE_TIME");
+  auto id = cachedSymbol(SYM_DamDiveTime);
   if(id==nullptr)
     return 0;
   return id->get_int();
@@ -2292,19 +2373,22 @@ bool GameScript::npc_checkinfo(std::shared_ptr<phoenix::c_npc> npcRef, int imp)
   if(n==nullptr || hero==nullptr)
     return false;
 
-  auto& pl  = hero->handle();
-  auto& npc = n->handle();
-  for(auto& info:dialogsInfo) {
-    if(info->npc!=int32_t(npc.symbol_index()) || info->important!=imp)
+  auto& pl   = hero->handle();
+  auto  dlg  = dialogsOf(n->handle());
+  if(dlg==nullptr)
+    return false;
+  for(auto id:*dlg) {
+    auto& info = dialogsInfo[id];
+    if(info->important!=imp)
       continue;
-    bool npcKnowsInfo = doesNpcKnowInfo(pl,info->symbol_index());
+    bool npcKnowsInfo = isInfoKnown(pl,id);
     if(npcKnowsInfo && !info->permanent)
       continue;
     bool valid=false;
     if(info->condition) {
       auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info->condition));
       if (conditionSymbol != nullptr)
-        valid = vm.call_function<int>(conditionSymbol)!=0;
+        valid = callFunction<int>(conditionSymbol)!=0;
       }
     if(valid) {
       return true;
@@ -3137,11 +3221,37 @@ void GameScript::sort(std::vector<GameScript::DlgChoice> &dlg) {
   }
 
 void GameScript::setNpcInfoKnown(const phoenix::c_npc& npc, const phoenix::c_info &info) {
-  auto id = std::make_pair(vm.find_symbol_by_instance(npc)->index(),vm.find_symbol_by_instance(info)->index());
-  dlgKnownInfos.insert(id);
+  setInfoKnown(npc.symbol_index(),dialogId(info.symbol_index()));
+  }
+
+void GameScript::setInfoKnown(size_t npcInstance, uint32_t dlgId) {
+  if(dlgId>=dialogsInfo.size())
+    return;
+  auto& bits = dlgKnownInfos[npcInstance];
+  bits.resize((dialogsInfo.size()+63)/64);
+  bits[dlgId/64] |= uint64_t(1) << (dlgId%64);
   }
 
 bool GameScript::doesNpcKnowInfo(const phoenix::c_npc& npc, size_t infoInstance) const {
-  auto id = std::make_pair(vm.find_symbol_by_instance(npc)->index(),infoInstance);
-  return dlgKnownInfos.find(id)!=dlgKnownInfos.end();
+  return isInfoKnown(npc,dialogId(infoInstance));
+  }
+
+bool GameScript::isInfoKnown(const phoenix::c_npc& npc, uint32_t dlgId) const {
+  auto i = dlgKnownInfos.find(npc.symbol_index());
+  if(i==dlgKnownInfos.end() || dlgId/64>=i->second.size())
+    return false;
+  return (i->second[dlgId/64] >> (dlgId%64)) & 1;
+  }
+
+uint32_t GameScript::dialogId(size_t infoInstance) const {
+  if(infoInstance<dialogsId.size())
+    return dialogsId[infoInstance];
+  return uint32_t(-1);
+  }
+
+const std::vector<uint32_t>* GameScript::dialogsOf(const phoenix::c_npc& npc) const {
+  auto i = dialogsByNpc.find(int32_t(npc.symbol_index()));
+  if(i==dialogsByNpc.end())
+    return nullptr;
+  return &i->second;
   }
@@ -5,7 +5,7 @@
 #include <phoenix/messages.hh>
 
 #include <memory>
-#include <set>
+#include <map>
 #include <random>
 
 #include <Tempest/Matrix4x4>
@@ -17,10 +17,12 @@
 #include "game/constants.h"
 #include "game/aistate.h"
 #include "game/questlog.h"
+#include "game/scriptprofiler.h"
 
 class GameSession;
 class World;
 class ScriptPlugin;
+class Mem32;
 class Npc;
 class Item;
 class VisualFx;
@@ -56,6 +58,9 @@ class GameScript final {
       };
 
     bool         hasSymbolName(std::string_view fn);
+    // entry points for engine code outside of GameScript, accounted in profiler
+    void         runFunction(std::string_view fname);
+    void         runMenuFunction(phoenix::vm& menuVm, phoenix::symbol* sym);
 
     void         initializeInstanceNpc(const std::shared_ptr<phoenix::c_npc>& npc, size_t instance);
     void         initializeInstanceItem(const std::shared_ptr<phoenix::c_item>& item, size_t instance);
@@ -156,7 +161,44 @@ class GameScript final {
     void      onWldItemRemoved(const Item& itm);
     void      fixNpcPosition(Npc& npc, float angle0, float distBias);
 
+    ScriptProfiler& profiler() { return prof; }
+    const Mem32*    scriptMemory() const;
+
   private:
+    // script symbols, used by engine callbacks
+    enum CachedSymbol : uint8_t {
+      SYM_CanNotUse,
+      SYM_CanNotCast,
+      SYM_TradeNotEnoughGold,
+      SYM_MobMissingItem,
+      SYM_MobMissingKey,
+      SYM_MobAnotherIsUsing,
+      SYM_MobMissingKeyOrLockpick,
+      SYM_MobMissingLockpick,
+      SYM_MobTooFar,
+      SYM_PlunderIsEmpty,
+      SYM_ProcessMana,
+      SYM_ProcessManaRelease,
+      SYM_PickLock,
+      SYM_CanNpcCollideWithSpell,
+      SYM_HotkeyScreenMap,
+      SYM_HotkeyLamePotion,
+      SYM_HotkeyLameHeal,
+      SYM_PercAssessMagic,
+      SYM_DamDiveTime,
+      SYM_Count
+      };
+
+    struct CachedSymbolEntry {
+      phoenix::symbol* sym      = nullptr;
+      bool             resolved = false;
+      };
+
+    struct NameHash {
+      using is_transparent = void;
+      size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+      };
+
     template<typename T>
     struct DetermineSignature {
       using signature = void();
@@ -183,8 +225,20 @@ class GameScript final {
 
     template <class F>
     void bindExternal(const std::string& name, F function) {
+      const uint32_t id = prof.addExternal(name);
       vm.register_external(name, std::function<typename DetermineSignature<F>::signature> (
-                                   [this, function](auto ... v) { return (this->*function)(v...); }));
+                                   [this, function, id](auto ... v) {
+                                     ScriptProfiler::Scope scope(prof,ScriptProfiler::K_External,id,"");
+                                     return (this->*function)(v...);
+                                     }));
+      }
+
+    template <class R = void, class ... P>
+    R callFunction(phoenix::symbol* sym, P&& ... args) {
+      if(sym==nullptr)
+        return vm.call_function<R>(sym, std::forward<P>(args)...);
+      ScriptProfiler::Scope scope(prof,ScriptProfiler::K_Function,sym->index(),sym->name());
+      return vm.call_function<R>(sym, std::forward<P>(args)...);
       }
 
     void  initCommon();
@@ -202,6 +256,10 @@ class GameScript final {
     auto  findInfo    (size_t id) -> phoenix::c_info*;
     auto  findFocus(std::string_view name) -> phoenix::c_focus;
 
+    static const char* cachedSymbolName(CachedSymbol s);
+    phoenix::symbol*   cachedSymbol(CachedSymbol s);
+    ScriptFn           findFunction(std::string_view name);
+
     void storeItem(Item* it);
 
     bool aiOutput   (Npc &from, std::string_view name, bool overlay);
@@ -419,7 +477,11 @@ class GameScript final {
 
     void sort(std::vector<DlgChoice>& dlg);
     void setNpcInfoKnown(const phoenix::c_npc& npc, const phoenix::c_info& info);
+    void setInfoKnown   (size_t npcInstance, uint32_t dlgId);
     bool doesNpcKnowInfo(const phoenix::c_npc& npc, size_t infoInstance) const;
+    bool isInfoKnown    (const phoenix::c_npc& npc, uint32_t dlgId) const;
+    auto dialogId       (size_t infoInstance) const -> uint32_t;
+    auto dialogsOf      (const phoenix::c_npc& npc) const -> const std::vector<uint32_t>*;
 
     void saveSym(Serialize& fout, phoenix::symbol& s);
 
@@ -428,6 +490,7 @@ class GameScript final {
 
     GameSession&                                                owner;
     phoenix::vm                                                 vm;
+    ScriptProfiler                                              prof;
     int32_t                                                     vmLang = -1;
     std::mt19937                                                randGen;
 
@@ -437,8 +500,13 @@ class GameScript final {
     std::unique_ptr<SvmDefinitions>                             svm;
     uint64_t                                                    svmBarrier=0;
 
-    std::set<std::pair<size_t,size_t>>                          dlgKnownInfos;
+    // npc symbol -> bit per known entry of dialogsInfo
+    std::map<size_t,std::vector<uint64_t>>                      dlgKnownInfos;
     std::vector<std::shared_ptr<phoenix::c_info>>               dialogsInfo;
+    // c_info symbol -> index in dialogsInfo
+    std::vector<uint32_t>                                       dialogsId;
+    // owner npc symbol -> indices in dialogsInfo
+    std::unordered_map<int32_t,std::vector<uint32_t>>           dialogsByNpc;
     phoenix::messages                                           dialogs;
     std::unordered_map<size_t,AiState>                          aiStates;
     std::unique_ptr<AiOuputPipe>                                aiDefaultPipe;
@@ -453,6 +521,8 @@ class GameScript final {
     float                                                       viewTimePerChar = 0.5;
     int32_t                                                     damCriticalMultiplier = 2;
     mutable std::unordered_map<std::string,uint32_t>            msgTimings;
+    CachedSymbolEntry                                           symCache[SYM_Count];
+    std::unordered_map<std::string,ScriptFn,NameHash,std::equal_to<>> fnByName;
     size_t                                                      gilTblSize=0;
     size_t                                                      gilCount=0;
     std::vector<int32_t>                                        gilAttitudes;
@@ -363,7 +363,7 @@ auto GameSession::implChangeWorld(std::unique_ptr<GameSession>&& game,
   setWorld(std::move(ret));
 
   if(!wss.isEmpty()) {
-    Tempest::MemReader rd {wss.storage.data(),wss.storage.size()};
+    Tempest::MemReader rd {wss.storage->data(),wss.storage->size()};
     Serialize          fin{rd};
     wrld->load(fin);
     }
@@ -449,7 +449,7 @@ bool GameSession::isWorldKnown(std::string_view name) const {
 void GameSession::initPerceptions() {
   // NOTE: world is null at this point and most scrip-api will be prone to crash
   if(vm->hasSymbolName("initPerceptions"))
-    vm->getVm().call_function("initPerceptions");
+    vm->runFunction("initPerceptions");
   }
 
 void GameSession::initScripts(bool firstTime) {
@@ -459,19 +459,19 @@ void GameSession::initScripts(bool firstTime) {
 
   if(firstTime) {
     if(vm->hasSymbolName("startup_global"))
-      vm->getVm().call_function("startup_global");
+      vm->runFunction("startup_global");
 
     string_frm startup("startup_", name);
     if(vm->hasSymbolName(startup))
-      vm->getVm().call_function(startup);
+      vm->runFunction(startup);
     }
 
   if(vm->hasSymbolName("init_global"))
-    vm->getVm().call_function("init_global");
+    vm->runFunction("init_global");
 
   string_frm init("init_",name);
   if(vm->hasSymbolName(init))
-    vm->getVm().call_function(init);
+    vm->runFunction(init);
 
   wrld->resetPositionToTA();
   }
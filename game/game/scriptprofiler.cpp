@@ -0,0 +1,169 @@
+#include "scriptprofiler.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+using namespace Tempest;
+
+const char* ScriptProfiler::kindName(Kind k) {
+  switch(k) {
+    case K_Function: return "fn ";
+    case K_External: return "ext";
+    case K_Menu:     return "mnu";
+    case K_Count:    break;
+    }
+  return "";
+  }
+
+uint32_t ScriptProfiler::addExternal(std::string_view name) {
+  auto& ext = stat[K_External];
+  ext.emplace_back();
+  ext.back().name = name;
+  return uint32_t(ext.size()-1);
+  }
+
+void ScriptProfiler::setEnabled(bool e) {
+  if(enabled==e)
+    return;
+  // toggling from within script call is not allowed: frames would not match
+  if(!stack.empty())
+    return;
+  enabled = e;
+  if(enabled) {
+    reset();
+    ring.resize(RingSize);
+    }
+  }
+
+void ScriptProfiler::reset() {
+  for(auto& s:stat)
+    for(auto& i:s) {
+      i.calls = 0;
+      i.incl  = 0;
+      i.excl  = 0;
+      }
+  epoch    = clock();
+  ringPos  = 0;
+  ringFull = false;
+  }
+
+uint64_t ScriptProfiler::clock() {
+  auto t = std::chrono::steady_clock::now().time_since_epoch();
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+  }
+
+uint64_t ScriptProfiler::now() const {
+  return clock()-epoch;
+  }
+
+void ScriptProfiler::enter(Kind k, uint32_t id, std::string_view name) {
+  auto& s = stat[k];
+  if(id>=s.size())
+    s.resize(id+1);
+  auto& st = s[id];
+  if(st.name.empty())
+    st.name = name;
+  st.depth++;
+
+  Frame f;
+  f.kind  = k;
+  f.id    = id;
+  f.start = now();
+  stack.push_back(f);
+  }
+
+void ScriptProfiler::leave() {
+  if(stack.empty())
+    return;
+  const Frame    f   = stack.back();
+  const uint64_t dur = now()-f.start;
+  stack.pop_back();
+
+  auto& st = stat[f.kind][f.id];
+  st.depth--;
+  st.calls++;
+  st.excl += dur-std::min(dur,f.child);
+  if(st.depth==0)
+    st.incl += dur; // recursive calls are accounted once
+  if(!stack.empty())
+    stack.back().child += dur;
+
+  auto& ev = ring[ringPos];
+  ev.kind  = f.kind;
+  ev.id    = f.id;
+  ev.start = f.start;
+  ev.dur   = dur;
+  ringPos  = (ringPos+1)%ring.size();
+  ringFull |= (ringPos==0);
+  }
+
+std::vector<std::string> ScriptProfiler::report(size_t maxLines) const {
+  struct Ref {
+    Kind        kind;
+    const Stat* st;
+    };
+  std::vector<Ref> all;
+  uint64_t         total = 0;
+  for(uint8_t k=0; k<K_Count; ++k)
+    for(auto& i:stat[k]) {
+      if(i.calls==0)
+        continue;
+      all.push_back({Kind(k),&i});
+      total += i.excl;
+      }
+  std::sort(all.begin(),all.end(),[](const Ref& l, const Ref& r){
+    return l.st->excl>r.st->excl;
+    });
+
+  std::vector<std::string> ret;
+  char buf[256] = {};
+  std::snprintf(buf,sizeof(buf),"script profile: %u entries, %.3f ms total",
+                unsigned(all.size()), double(total)/1000000.0);
+  ret.push_back(buf);
+  for(size_t i=0; i<all.size() && i<maxLines; ++i) {
+    auto& st = *all[i].st;
+    std::snprintf(buf,sizeof(buf),"  %-32.32s %s calls: %8llu  incl: %9.3f ms  excl: %9.3f ms",
+                  st.name.c_str(), kindName(all[i].kind),
+                  static_cast<unsigned long long>(st.calls),
+                  double(st.incl)/1000000.0, double(st.excl)/1000000.0);
+    ret.push_back(buf);
+    }
+  return ret;
+  }
+
+bool ScriptProfiler::saveTrace(const std::string& path) const {
+  std::string json = "{\"traceEvents\":[\n";
+  const size_t count = ringFull ? ring.size() : ringPos;
+  const size_t first = ringFull ? ringPos     : 0;
+
+  char buf[128] = {};
+  for(size_t i=0; i<count; ++i) {
+    auto& ev = ring[(first+i)%ring.size()];
+    if(i>0)
+      json += ",\n";
+    json += "{\"name\":\"";
+    for(auto c:stat[ev.kind][ev.id].name)
+      if(c!='"' && c!='\\')
+        json.push_back(c);
+    std::snprintf(buf,sizeof(buf),"\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                  ev.kind==K_External ? "external" : (ev.kind==K_Menu ? "menu" : "function"),
+                  double(ev.start)/1000.0, double(ev.dur)/1000.0);
+    json += buf;
+    }
+  json += "\n]}\n";
+
+  try {
+    WFile f(path);
+    f.write(json.data(),json.size());
+    f.flush();
+    }
+  catch(...) {
+    Log::e("unable to write script trace: ", path);
+    return false;
+    }
+  return true;
+  }
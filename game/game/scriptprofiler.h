@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// opt-in timing of script functions, called by engine, and of engine externals, called by script
+class ScriptProfiler final {
+  public:
+    enum Kind : uint8_t {
+      K_Function,
+      K_External,
+      K_Menu,
+      K_Count
+      };
+
+    class Scope final {
+      public:
+        Scope(ScriptProfiler& p, Kind k, uint32_t id, std::string_view name)
+          :owner(p.enabled ? &p : nullptr) {
+          if(owner!=nullptr)
+            owner->enter(k,id,name);
+          }
+        ~Scope() {
+          if(owner!=nullptr)
+            owner->leave();
+          }
+        Scope(const Scope&) = delete;
+        Scope& operator = (const Scope&) = delete;
+
+      private:
+        ScriptProfiler* owner = nullptr;
+      };
+
+    uint32_t addExternal(std::string_view name);
+
+    bool     isEnabled() const { return enabled; }
+    void     setEnabled(bool e);
+    void     reset();
+
+    // flat report, sorted by exclusive time
+    auto     report(size_t maxLines) const -> std::vector<std::string>;
+    bool     saveTrace(const std::string& path) const;
+
+  private:
+    // last events for chrome-trace
+    static constexpr size_t RingSize = 1 << 16;
+
+    struct Stat {
+      std::string name;
+      uint64_t    calls = 0;
+      uint64_t    incl  = 0; // ns
+      uint64_t    excl  = 0; // ns
+      uint32_t    depth = 0; // recursion
+      };
+
+    struct Frame {
+      Kind        kind  = K_Function;
+      uint32_t    id    = 0;
+      uint64_t    start = 0;
+      uint64_t    child = 0;
+      };
+
+    struct Event {
+      Kind        kind  = K_Function;
+      uint32_t    id    = 0;
+      uint64_t    start = 0;
+      uint64_t    dur   = 0;
+      };
+
+    void     enter(Kind k, uint32_t id, std::string_view name);
+    void     leave();
+    uint64_t now() const;
+    static uint64_t clock();
+    static const char* kindName(Kind k);
+
+    bool                     enabled = false;
+    uint64_t                 epoch   = 0;
+    std::vector<Stat>        stat[K_Count];
+    std::vector<Frame>       stack;
+    std::vector<Event>       ring;
+    size_t                   ringPos = 0;
+    bool                     ringFull = false;
+  };
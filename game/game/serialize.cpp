@@ -1,6 +1,11 @@
 #include "serialize.h"
 
+#include <atomic>
 #include <cstring>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #include "savegameheader.h"
 #include "world/world.h"
@@ -54,7 +59,7 @@ Serialize::Serialize() {}
 
 //static uint64_t time0 = 0;
 
-Serialize::Serialize(Tempest::ODevice& fout) : fout(&fout) {
+Serialize::Serialize(Tempest::ODevice& fout, Compression level) : fout(&fout), level(level) {
   //time0 = Tempest::Application::tickCount();
   entryBuf .reserve(1*1024*1024);
   entryName.reserve(256);
@@ -75,15 +80,142 @@ Serialize::Serialize(Tempest::IDevice& fin) : fin(&fin) {
   mz_zip_reader_init(&impl, fin.size(), 0);
   }
 
+Serialize::Serialize(Snapshot& snap) : snap(&snap) {
+  entryBuf .reserve(1*1024*1024);
+  entryName.reserve(256);
+  }
+
 Serialize::~Serialize() {
-  closeEntry();
+  if(snap!=nullptr) {
+    closeEntry();
+    return;
+    }
   if(fout!=nullptr) {
-    mz_zip_writer_finalize_archive(&impl);
+    if(!finished) {
+      try {
+        finish();
+        }
+      catch(const std::exception& e) {
+        Tempest::Log::e("save error: ", e.what());
+        }
+      }
     mz_zip_writer_end(&impl);
     //Tempest::Log::d("save time = ", Tempest::Application::tickCount()-time0);
     }
   }
 
+void Serialize::append(Snapshot&& s) {
+  closeEntry();
+  auto& dst = pending();
+  if(dst.empty()) {
+    dst = std::move(s);
+    return;
+    }
+  dst.reserve(dst.size()+s.size());
+  for(auto& i:s)
+    dst.emplace_back(std::move(i));
+  s.clear();
+  }
+
+void Serialize::finish() {
+  if(fout==nullptr || finished)
+    return;
+  finished = true;
+  closeEntry();
+  writeEntries();
+  if(!mz_zip_writer_finalize_archive(&impl))
+    throw std::runtime_error("unable to finalize game archive");
+  }
+
+void Serialize::writeEntries() {
+  struct Packed {
+    void*    data = nullptr;
+    size_t   size = 0;
+    uint32_t crc  = 0;
+    bool     done = false;
+    };
+
+  auto&               src = entries;
+  std::vector<Packed> packed(src.size());
+  std::mutex              sync;
+  std::condition_variable ready;
+  std::atomic_size_t      next{0};
+
+  const int lvl   = (level==C_Fast ? MZ_BEST_SPEED : (level==C_Default ? MZ_DEFAULT_LEVEL : MZ_BEST_COMPRESSION));
+  const int flags = int(tdefl_create_comp_flags_from_zip_params(lvl, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+
+  // NOTE: Workers are owned by main thread, while writer may run concurrently with game-loop
+  auto pack = [&]() {
+    while(true) {
+      const size_t i = next.fetch_add(1);
+      if(i>=src.size())
+        break;
+      auto& e = src[i];
+      auto& p = packed[i];
+      try {
+        const bool stored = (e.blob!=nullptr);
+        if(stored) {
+          e.data.insert(e.data.end(), e.blob->begin(), e.blob->end());
+          e.blob = nullptr;
+          }
+        else if(e.image!=nullptr) {
+          std::vector<uint8_t> tmp;
+          Tempest::MemWriter   w{tmp};
+          e.image->save(w);
+          e.data.insert(e.data.begin()+ptrdiff_t(e.imageAt), tmp.begin(), tmp.end());
+          e.image = nullptr;
+          }
+        if(e.data.size()>256 && !stored) {
+          p.crc  = uint32_t(mz_crc32(MZ_CRC32_INIT, e.data.data(), e.data.size()));
+          p.data = tdefl_compress_mem_to_heap(e.data.data(), e.data.size(), &p.size, flags);
+          }
+        }
+      catch(...) {
+        // keep entry uncompressed
+        }
+      std::lock_guard<std::mutex> guard(sync);
+      p.done = true;
+      ready.notify_one();
+      }
+    };
+
+  const size_t thCount = std::min<size_t>(std::max(1u,std::thread::hardware_concurrency()), (src.size()+7)/8);
+  std::vector<std::future<void>> th;
+  if(thCount<=1) {
+    pack();
+    } else {
+    for(size_t i=0; i<thCount; ++i)
+      th.emplace_back(std::async(std::launch::async,pack));
+    }
+
+  // stream entries to archive in order, while the rest is compressed
+  mz_bool status = MZ_TRUE;
+  for(size_t i=0; i<src.size(); ++i) {
+    auto& e = src[i];
+    auto& p = packed[i];
+    {
+    std::unique_lock<std::mutex> guard(sync);
+    ready.wait(guard,[&p](){ return p.done; });
+    }
+    if(status) {
+      if(p.data!=nullptr && p.size<e.data.size()) {
+        status = mz_zip_writer_add_mem_ex(&impl, e.name.c_str(), p.data, p.size, nullptr, 0,
+                                          MZ_ZIP_FLAG_COMPRESSED_DATA, e.data.size(), p.crc);
+        } else {
+        status = mz_zip_writer_add_mem(&impl, e.name.c_str(), e.data.data(), e.data.size(), MZ_NO_COMPRESSION);
+        }
+      }
+    mz_free(p.data);
+    p.data = nullptr;
+    e.data = std::vector<uint8_t>();
+    }
+  for(auto& i:th)
+    i.wait();
+  src.clear();
+  if(!status)
+    throw std::runtime_error("unable to write entry in game archive");
+  }
+
 std::string_view Serialize::worldName() const {
   if(ctx!=nullptr)
     return ctx->name();
@@ -91,22 +223,35 @@ std::string_view Serialize::worldName() const {
   }
 
 void Serialize::closeEntry() {
-  if(fout==nullptr)
+  if(!isWriter())
     return;
-  if(entryBuf.empty())
+  if(entryBuf.empty() && entryImg==nullptr && entryBlob==nullptr)
     return;
 
-  mz_uint level  = entryBuf.size()>256 ? MZ_BEST_COMPRESSION : MZ_NO_COMPRESSION;
-  mz_bool status = mz_zip_writer_add_mem(&impl, entryName.c_str(), entryBuf.data(), entryBuf.size(), level);
+  Entry e;
+  e.name    = entryName;
+  e.data.assign(entryBuf.begin(),entryBuf.end());
+  e.image   = std::move(entryImg);
+  e.imageAt = entryImgAt;
+  e.blob    = std::move(entryBlob);
+  pending().emplace_back(std::move(e));
+
   entryBuf .clear();
   entryName.clear();
-  if(!status)
-    throw std::runtime_error("unable to write entry in game archive");
+  entryImg   = nullptr;
+  entryImgAt = 0;
+  entryBlob  = nullptr;
+  }
+
+void Serialize::writeBlob(std::shared_ptr<const std::vector<uint8_t>> blob) {
+  if(!isWriter() || entryImg!=nullptr || entryBlob!=nullptr)
+    throw std::logic_error("unable to write blob in game archive");
+  entryBlob = std::move(blob);
   }
 
 bool Serialize::implSetEntry(std::string_view fname) {
   size_t prefix = 0;
-  if(fout!=nullptr) {
+  if(isWriter()) {
     while(prefix<fname.size() && prefix<entryName.size()) {
       if(entryName[prefix]!=fname[prefix])
         break;
@@ -115,18 +260,15 @@ bool Serialize::implSetEntry(std::string_view fname) {
     }
   closeEntry();
   entryName = fname;
-  if(fout!=nullptr) {
+  if(isWriter()) {
     for(size_t i=prefix; i<entryName.size(); ++i) {
       if(entryName[i]=='/' && i+1<entryName.size()) {
-        const char prev = entryName[i+1];
-        entryName[i+1] = '\0';
-        mz_uint32 id = mz_uint32(-1);
-        if(!mz_zip_reader_locate_file_v2(&impl, entryName.c_str(), nullptr, 0, &id)) {
-          mz_bool status = mz_zip_writer_add_mem(&impl, entryName.c_str(), NULL, 0, MZ_NO_COMPRESSION);
-          if(!status)
-            throw std::runtime_error("unable to allocate entry in game archive");
+        auto dir = entryName.substr(0,i+1);
+        if(dirs.insert(dir).second) {
+          Entry e;
+          e.name = std::move(dir);
+          pending().emplace_back(std::move(e));
           }
-        entryName[i+1] = prev;
         }
       }
     return true;
@@ -167,6 +309,8 @@ uint32_t Serialize::implDirectorySize(std::string_view e) {
 void Serialize::writeBytes(const void* buf, size_t sz) {
   if(sz==0)
     return;
+  if(entryBlob!=nullptr)
+    throw std::logic_error("blob must be last in game archive entry");
   size_t at = entryBuf.size();
   entryBuf.resize(entryBuf.size()+sz);
   std::memcpy(&entryBuf[at],buf,sz);
@@ -179,6 +323,18 @@ void Serialize::readBytes(void* buf, size_t sz) {
   readOffset+=sz;
   }
 
+void Serialize::seekEntry(size_t at) {
+  if(fin==nullptr || at>entryBuf.size())
+    throw std::runtime_error("unable to read save-game file");
+  readOffset = at;
+  }
+
+void Serialize::writeBytesAt(size_t at, const void* buf, size_t sz) {
+  if(!isWriter() || at+sz>entryBuf.size())
+    throw std::runtime_error("unable to write save-game file");
+  std::memcpy(&entryBuf[at],buf,sz);
+  }
+
 void Serialize::implWrite(const std::string& s) {
   uint32_t sz=uint32_t(s.size());
   implWrite(sz);
@@ -273,6 +429,12 @@ void Serialize::implRead(SaveGameHeader& p) {
   }
 
 void Serialize::implWrite(const Tempest::Pixmap& p) {
+  if(entryImg==nullptr) {
+    // deferred: encoding is done by writer
+    entryImg   = std::make_shared<Tempest::Pixmap>(p);
+    entryImgAt = entryBuf.size();
+    return;
+    }
   std::vector<uint8_t> tmp;
   tmp.reserve(4*1024*1024);
   Tempest::MemWriter w{tmp};
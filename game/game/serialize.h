@@ -7,6 +7,8 @@
 #include <Tempest/Matrix4x4>
 
 #include <vector>
+#include <memory>
+#include <unordered_set>
 #include <cstdint>
 #include <array>
 #include <type_traits>
@@ -34,10 +36,28 @@ class SaveGameHeader;
 class Serialize {
   public:
     enum Version : uint16_t {
-      Current = 46
+      Current = 47
       };
-    Serialize(Tempest::ODevice& fout);
+    enum Compression : uint8_t {
+      C_Fast,
+      C_Default,
+      C_Best,
+      };
+
+    struct Entry {
+      std::string                            name;
+      std::vector<uint8_t>                   data;
+      // screenshot is encoded by writer, to keep snapshot cheap
+      std::shared_ptr<const Tempest::Pixmap> image;
+      size_t                                 imageAt = 0;
+      // already compressed payload, shared with owner and stored as-is
+      std::shared_ptr<const std::vector<uint8_t>> blob;
+      };
+    using Snapshot = std::vector<Entry>;
+
+    Serialize(Tempest::ODevice& fout, Compression level = C_Best);
     Serialize(Tempest::IDevice&  fin);
+    Serialize(Snapshot&         snap);
     Serialize(Serialize&&)=default;
     ~Serialize();
 
@@ -65,6 +85,14 @@ class Serialize {
     void writeBytes(const void* v,size_t sz);
     void readBytes (void* v,size_t sz);
 
+    // writer only: append shared payload to current entry, without copy and recompression
+    void writeBlob(std::shared_ptr<const std::vector<uint8_t>> blob);
+
+    // random access within current entry
+    size_t entryOffset() const { return fin!=nullptr ? size_t(readOffset) : entryBuf.size(); }
+    void   seekEntry(size_t at);
+    void   writeBytesAt(size_t at, const void* v, size_t sz);
+
     template<class ... Arg>
     void write(const Arg& ... a){
       (implWrite(a),... );
@@ -76,6 +104,12 @@ class Serialize {
       }
 
     void readNpc(phoenix::vm& vm, std::shared_ptr<phoenix::c_npc>& npc);
+
+    // writer only: append entries, recorded by in-memory snapshot
+    void append(Snapshot&& s);
+    // writer only: compress pending entries and finalize archive
+    void finish();
+
   private:
     Serialize();
 
@@ -271,6 +305,9 @@ class Serialize {
     void   closeEntry();
     bool   implSetEntry(std::string_view e);
     uint32_t implDirectorySize(std::string_view e);
+    bool   isWriter() const { return fout!=nullptr || snap!=nullptr; }
+    auto   pending() -> Snapshot& { return snap!=nullptr ? *snap : entries; }
+    void   writeEntries();
 
     uint16_t                 curVer = Version::Current;
     uint16_t                 wldVer = Version::Current;
@@ -281,9 +318,18 @@ class Serialize {
     mz_zip_archive           impl      = {};
     std::string              entryName;
     std::vector<uint8_t>     entryBuf;
+    std::shared_ptr<const Tempest::Pixmap> entryImg;
+    size_t                   entryImgAt = 0;
+    std::shared_ptr<const std::vector<uint8_t>> entryBlob;
     uint64_t                 curOffset = 0;
     uint64_t                 readOffset = 0;
     Tempest::ODevice*        fout      = nullptr;
     Tempest::IDevice*        fin       = nullptr;
+
+    Snapshot*                snap      = nullptr;
+    Snapshot                 entries;
+    std::unordered_set<std::string> dirs;
+    Compression              level     = C_Best;
+    bool                     finished  = false;
   };
 
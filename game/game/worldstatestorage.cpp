@@ -9,19 +9,31 @@
 
 WorldStateStorage::WorldStateStorage(World &w)
   :name(w.name()){
-  Tempest::MemWriter wr{storage};
+  auto data = std::make_shared<std::vector<uint8_t>>();
+  {
+  Tempest::MemWriter wr{*data};
   Serialize          sr{wr};
   w.save(sr);
   }
+  storage = std::move(data);
+  }
 
 void WorldStateStorage::save(Serialize &fout) const {
   fout.setEntry("worlds/",name,".zip");
-  fout.write(storage);
+  if(storage==nullptr) {
+    fout.write(uint32_t(0));
+    return;
+    }
+  // same layout as std::vector, but blob is not copied nor deflated again
+  fout.write(uint32_t(storage->size()));
+  fout.writeBlob(storage);
   }
 
 void WorldStateStorage::load(Serialize& fin) {
+  auto data = std::make_shared<std::vector<uint8_t>>();
   fin.setEntry("worlds/",name,".zip");
-  fin.read(storage);
+  fin.read(*data);
+  storage = std::move(data);
   }
 
 bool WorldStateStorage::compareName(std::string_view n) const {
@@ -19,12 +19,13 @@ class WorldStateStorage final {
     WorldStateStorage(WorldStateStorage&&)=default;
     WorldStateStorage& operator = (WorldStateStorage&&)=default;
 
-    bool                 isEmpty() const { return storage.empty(); }
+    bool                 isEmpty() const { return storage==nullptr || storage->empty(); }
     void                 save(Serialize& fout) const;
     void                 load(Serialize& fin);
 
     bool                 compareName(std::string_view name) const;
 
     std::string          name;
-    std::vector<uint8_t> storage;
+    // compressed world archive; immutable, so shared with pending save-game writers
+    std::shared_ptr<const std::vector<uint8_t>> storage;
   };
@@ -1,8 +1,10 @@
 #include "gothic.h"
 
+#include <Tempest/File>
 #include <Tempest/Log>
 #include <Tempest/TextCodec>
 
+#include <algorithm>
 #include <cstring>
 #include <cctype>
 
@@ -19,6 +21,8 @@
 
 #include "utils/fileutil.h"
 #include "utils/inifile.h"
+#include "utils/workers.h"
+#include "game/serialize.h"
 
 #include "commandline.h"
 
@@ -73,6 +77,7 @@ Gothic::Gothic() {
   if(hasMeshShader()) {
     opts.doMeshShading = CommandLine::inst().isMeshShading();
     }
+  opts.doSoftwareOcclusion = CommandLine::inst().isSwOcclusion();
 
   wrldDef = CommandLine::inst().wrldDef;
 
@@ -106,6 +111,9 @@ Gothic::Gothic() {
   defaults->set("ENGINE",       "zEnvMappingEnabled", 1); // reflections
   defaults->set("ENGINE",       "zCloudShadowScale", gpu.type==Tempest::DeviceType::Discrete); // ssao
   defaults->set("INTERNAL",     "vidResIndex", 0); // full-res
+  defaults->set("INTERNAL",     "saveCompression", 2); // 0 - fast, 1 - default, 2 - best
+  defaults->set("INTERNAL",     "animLodNear", 1500.f); // full-rate animation; 0 - no animation lod
+  defaults->set("INTERNAL",     "animLodFar",  4000.f); // half-rate animation up to, quarter-rate beyond
 
   defaults->set("VIDEO", "zVidBrightness", 0.5f);
   defaults->set("VIDEO", "zVidContrast",   0.5f);
@@ -199,6 +207,7 @@ Gothic::Gothic() {
   }
 
 Gothic::~Gothic() {
+  finishSave();
   instance = nullptr;
   }
 
@@ -426,51 +435,77 @@ Gothic::LoadState Gothic::checkLoading() const {
 
 bool Gothic::finishLoading() {
   auto state = checkLoading();
-  if(state!=LoadState::Finalize && state!=LoadState::FailedLoad && state!=LoadState::FailedSave)
+  if(state!=LoadState::Finalize && state!=LoadState::FailedLoad)
     return false;
   if(loadingFlag.compare_exchange_strong(state,LoadState::Idle)){
     loaderTh.join();
     if(pendingGame!=nullptr)
       game = std::move(pendingGame);
-    saveTex = Texture2d();
     onWorldLoaded();
     return true;
     }
   return false;
   }
 
-void Gothic::startSave(Tempest::Texture2d&& tex,
-                       const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
-  saveTex = std::move(tex);
-  implStartLoadSave("",false,f);
+void Gothic::startSave(std::string_view slot, std::string_view usrName, const Tempest::Pixmap& screen) {
+  if(game==nullptr || checkLoading()!=LoadState::Idle)
+    return;
+  finishSave();
+
+  // snapshot is taken in game-thread; compression and file io are done by save-thread
+  auto snap = std::make_shared<Serialize::Snapshot>();
+  try {
+    Serialize s(*snap);
+    game->save(s,usrName,screen);
+    }
+  catch(const std::exception& e) {
+    Tempest::Log::e("save error: ", e.what());
+    onPrint("unable to write savegame file");
+    return;
+    }
+
+  const auto level = Serialize::Compression(std::clamp(settingsGetI("INTERNAL","saveCompression"),0,2));
+  saveTh = std::thread([this,slot=std::string(slot),snap,level]() noexcept {
+    Workers::setThreadName("Save thread");
+    try {
+      Tempest::WFile f(slot);
+      Serialize      s(f,level);
+      s.append(std::move(*snap));
+      s.finish();
+      }
+    catch(const std::exception& e) {
+      Tempest::Log::e("save error: ", e.what());
+      saveFailed.store(true);
+      }
+    });
   }
 
-void Gothic::startLoad(std::string_view banner,
-                       const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
-  implStartLoadSave(banner,true,f);
+void Gothic::finishSave() {
+  if(saveTh.joinable())
+    saveTh.join();
   }
 
-void Gothic::implStartLoadSave(std::string_view banner,
-                               bool load,
-                               const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
-  loadTex = banner.empty() ? &saveTex : Resources::loadTexture(banner);
+void Gothic::startLoad(std::string_view banner,
+                       const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
+  loadTex = banner.empty() ? nullptr : Resources::loadTexture(banner);
   loadProgress.store(0);
 
   auto zero=LoadState::Idle;
-  auto one =load ? LoadState::Loading : LoadState::Saving;
-  if(!loadingFlag.compare_exchange_strong(zero,one)){
+  if(!loadingFlag.compare_exchange_strong(zero,LoadState::Loading)){
     return; // loading already
     }
+  // savegame slot may be still in use by save-thread
+  finishSave();
 
   onStartLoading();
   auto g = clearGame().release();
   try{
-    auto l = std::thread([this,f,g,one]() noexcept {
+    auto l = std::thread([this,f,g]() noexcept {
       Workers::setThreadName("Loading thread");
       std::unique_ptr<GameSession> game(g);
       std::unique_ptr<GameSession> next;
-      auto curState = one;
-      auto err = (curState==LoadState::Loading) ? LoadState::FailedLoad : LoadState::FailedSave;
+      auto curState = LoadState::Loading;
+      auto err      = LoadState::FailedLoad;
       try {
         next        = f(std::move(game));
         pendingGame = std::move(next);
@@ -496,10 +531,6 @@ void Gothic::implStartLoadSave(std::string_view banner,
         Tempest::Log::e("loading error: ", e.what());
         loadingFlag.compare_exchange_strong(curState,err);
         }
-      if(curState==LoadState::Saving) {
-        if(game!=nullptr)
-          pendingGame = std::move(game);
-        }
       });
     loaderTh=std::move(l);
     //loaderTh.join();
@@ -518,6 +549,9 @@ void Gothic::cancelLoading() {
   }
 
 void Gothic::tick(uint64_t dt) {
+  if(saveFailed.exchange(false))
+    onPrint("unable to write savegame file");
+
   if(pendingChapter){
     if(aiIsDlgFinished()) {
       onIntroChapter(chapter);
@@ -6,6 +6,7 @@
 
 #include <Tempest/Signal>
 #include <Tempest/Dir>
+#include <Tempest/Pixmap>
 
 #include <phoenix/vm.hh>
 
@@ -35,16 +36,15 @@ class Gothic final {
     enum class LoadState:int {
       Idle       = 0,
       Loading    = 1,
-      Saving     = 2,
-      Finalize   = 3,
-      FailedLoad = 4,
-      FailedSave = 5
+      Finalize   = 2,
+      FailedLoad = 3
       };
 
     struct Options {
       bool  doRayQuery          = false;
       bool  doRtGi              = false;
       bool  doMeshShading       = false;
+      bool  doSoftwareOcclusion = false;
 
       bool  hideFocus           = false;
       float cameraFov           = 67.5f;
@@ -124,7 +124,9 @@ class Gothic final {
     LoadState    checkLoading() const;
     bool         finishLoading();
     void         startLoad(std::string_view banner, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
-    void         startSave(Tempest::Texture2d&& tex, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
+    void         startSave(std::string_view slot, std::string_view usrName, const Tempest::Pixmap& screen);
+    bool         isSaving() const { return saveTh.joinable(); }
+    void         finishSave();
     void         cancelLoading();
 
     void         tick(uint64_t dt);
@@ -202,9 +204,10 @@ class Gothic final {
     std::unique_ptr<IniFile>                systemPackIniFile;
 
     const Tempest::Texture2d*               loadTex=nullptr;
-    Tempest::Texture2d                      saveTex;
     std::atomic_int                         loadProgress{0};
     std::thread                             loaderTh;
+    std::thread                             saveTh;
+    std::atomic_bool                        saveFailed{false};
     std::atomic<LoadState>                  loadingFlag{LoadState::Idle};
 
     std::unique_ptr<GameSession>            game, pendingGame;
@@ -229,10 +232,6 @@ class Gothic final {
 
     static Gothic*                          instance;
 
-    void                                    implStartLoadSave(std::string_view banner,
-                                                              bool load,
-                                                              const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
-
     void                                    detectGothicVersion();
     void                                    setupSettings();
 
@@ -1,5 +1,13 @@
 #include "frustrum.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define FRUSTRUM_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FRUSTRUM_NEON
+#endif
+
 using namespace Tempest;
 
 void Frustrum::make(const Matrix4x4& m, int32_t w, int32_t h) {
@@ -133,6 +141,65 @@ bool Frustrum::testPoint(const Vec3& p, float R, float& dist) const {
   return true;
   }
 
+void Frustrum::testSpheres(const Frustrum f[], uint8_t fCount,
+                           const float* x, const float* y, const float* z, const float* r,
+                           size_t count, uint8_t* mask) {
+  std::memset(mask,0,count);
+
+  size_t i = 0;
+#if defined(FRUSTRUM_SSE2)
+  for(; i+4<=count; i+=4) {
+    const __m128 px = _mm_loadu_ps(x+i);
+    const __m128 py = _mm_loadu_ps(y+i);
+    const __m128 pz = _mm_loadu_ps(z+i);
+    const __m128 nr = _mm_sub_ps(_mm_setzero_ps(),_mm_loadu_ps(r+i));
+    for(uint8_t c=0; c<fCount; ++c) {
+      auto&  fr  = f[c].f;
+      __m128 vis = _mm_castsi128_ps(_mm_set1_epi32(-1));
+      for(int p=0; p<6; ++p) {
+        __m128 d = _mm_add_ps(_mm_mul_ps(px,_mm_set1_ps(fr[p][0])),_mm_mul_ps(py,_mm_set1_ps(fr[p][1])));
+        d   = _mm_add_ps(d,_mm_add_ps(_mm_mul_ps(pz,_mm_set1_ps(fr[p][2])),_mm_set1_ps(fr[p][3])));
+        // same as testPoint: invisible, if d<=-R
+        vis = _mm_and_ps(vis,_mm_cmpnle_ps(d,nr));
+        }
+      const int bits = _mm_movemask_ps(vis);
+      for(int l=0; l<4; ++l)
+        if(bits & (1<<l))
+          mask[i+size_t(l)] |= uint8_t(1u<<c);
+      }
+    }
+#elif defined(FRUSTRUM_NEON)
+  for(; i+4<=count; i+=4) {
+    const float32x4_t px = vld1q_f32(x+i);
+    const float32x4_t py = vld1q_f32(y+i);
+    const float32x4_t pz = vld1q_f32(z+i);
+    const float32x4_t nr = vnegq_f32(vld1q_f32(r+i));
+    for(uint8_t c=0; c<fCount; ++c) {
+      auto&      fr  = f[c].f;
+      uint32x4_t vis = vdupq_n_u32(0xFFFFFFFF);
+      for(int p=0; p<6; ++p) {
+        float32x4_t d = vmlaq_n_f32(vdupq_n_f32(fr[p][3]),px,fr[p][0]);
+        d   = vmlaq_n_f32(d,py,fr[p][1]);
+        d   = vmlaq_n_f32(d,pz,fr[p][2]);
+        // same as testPoint: invisible, if d<=-R
+        vis = vbicq_u32(vis,vcleq_f32(d,nr));
+        }
+      uint32_t bits[4] = {};
+      vst1q_u32(bits,vis);
+      for(size_t l=0; l<4; ++l)
+        if(bits[l]!=0)
+          mask[i+l] |= uint8_t(1u<<c);
+      }
+    }
+#endif
+
+  for(; i<count; ++i) {
+    for(uint8_t c=0; c<fCount; ++c)
+      if(f[c].testPoint(x[i],y[i],z[i],r[i]))
+        mask[i] |= uint8_t(1u<<c);
+    }
+  }
+
 Frustrum::Ret Frustrum::testBbox(const Tempest::Vec3& min, const Tempest::Vec3& max) const {
   auto ret = Ret::T_Full;
   for(int i=0; i<6; i++) {
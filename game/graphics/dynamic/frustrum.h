@@ -19,6 +19,11 @@ class Frustrum {
       };
     Ret  testBbox (const Tempest::Vec3& min, const Tempest::Vec3& max) const;
 
+    // packed spheres(x,y,z,r arrays of 'count') against 'fCount' frustums: bit 'i' of mask[id] is set, if visible in f[i]
+    static void testSpheres(const Frustrum f[], uint8_t fCount,
+                            const float* x, const float* y, const float* z, const float* r,
+                            size_t count, uint8_t* mask);
+
     float              f[6][4] = {};
     Tempest::Matrix4x4 mat;
     uint32_t           width  = 0;
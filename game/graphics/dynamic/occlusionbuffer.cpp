@@ -0,0 +1,276 @@
+#include "occlusionbuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "graphics/mesh/submesh/packedmesh.h"
+#include "utils/workers.h"
+#include "frustrum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define OCCLUSION_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define OCCLUSION_NEON
+#endif
+
+using namespace Tempest;
+
+void OcclusionBuffer::addOccluders(const PackedMesh& mesh, size_t iboOffset, size_t iboLength) {
+  const size_t first = iboOffset/PackedMesh::MaxInd;
+  const size_t count = iboLength/PackedMesh::MaxInd;
+  for(size_t k=first; k<first+count && k<mesh.meshletBounds.size(); ++k) {
+    auto& b = mesh.meshletBounds[k];
+    if(b.r<MinOccluderR)
+      continue;
+
+    const size_t vbo = k*PackedMesh::MaxVert;
+    const size_t ibo = k*PackedMesh::MaxInd;
+    if(vbo+PackedMesh::MaxVert>mesh.vertices.size() || ibo+PackedMesh::MaxInd>mesh.indices.size())
+      break;
+
+    // drop padding: degenerated triangles at the end of meshlet
+    size_t indCount = PackedMesh::MaxInd;
+    while(indCount>0) {
+      auto* t = &mesh.indices[ibo+indCount-3];
+      if(t[0]!=t[1] || t[1]!=t[2])
+        break;
+      indCount -= 3;
+      }
+    if(indCount==0)
+      continue;
+
+    Occluder occ;
+    occ.pos       = b.pos;
+    occ.r         = b.r;
+    occ.firstVert = uint32_t(vert.size());
+    occ.firstInd  = uint32_t(ind.size());
+    occ.indCount  = uint32_t(indCount);
+    occ.vertCount = PackedMesh::MaxVert;
+    for(size_t i=0; i<PackedMesh::MaxVert; ++i) {
+      auto& v = mesh.vertices[vbo+i];
+      vert.emplace_back(v.pos[0],v.pos[1],v.pos[2]);
+      }
+    for(size_t i=0; i<indCount; ++i)
+      ind.push_back(uint8_t(mesh.indices[ibo+i]-vbo));
+    occluders.push_back(occ);
+    }
+  }
+
+void OcclusionBuffer::rasterize(const Frustrum& f) {
+  std::memcpy(clip,f.mat.data(),sizeof(clip));
+  depth.assign(size_t(Width*Height),0.f);
+  ready = false;
+
+  active.clear();
+  for(auto& i:occluders) {
+    if(!f.testPoint(i.pos,i.r))
+      continue;
+    const float w = clip[3]*i.pos.x + clip[7]*i.pos.y + clip[11]*i.pos.z + clip[15];
+    Active a;
+    a.occ    = &i;
+    a.weight = i.r/std::max(w,NearW);
+    active.push_back(a);
+    }
+  if(active.size()>MaxOccluders) {
+    // biggest on screen first
+    std::nth_element(active.begin(),active.begin()+MaxOccluders,active.end(),[](const Active& l, const Active& r){
+      return l.weight>r.weight;
+      });
+    active.resize(MaxOccluders);
+    }
+
+  uint32_t screenSz = 0;
+  for(auto& i:active) {
+    i.screen  = screenSz;
+    screenSz += i.occ->vertCount;
+    }
+  screen.resize(screenSz);
+
+  Workers::parallelFor(active,[this](Active& a) {
+    auto& occ = *a.occ;
+    for(uint32_t i=0; i<occ.vertCount; ++i) {
+      auto& v = vert[occ.firstVert+i];
+      auto& s = screen[a.screen+i];
+      const float x = clip[0]*v.x + clip[4]*v.y + clip[ 8]*v.z + clip[12];
+      const float y = clip[1]*v.x + clip[5]*v.y + clip[ 9]*v.z + clip[13];
+      const float w = clip[3]*v.x + clip[7]*v.y + clip[11]*v.z + clip[15];
+      s.valid = (w>=NearW);
+      if(!s.valid)
+        continue;
+      s.z = 1.f/w;
+      s.x = (x*s.z*0.5f+0.5f)*float(Width);
+      s.y = (y*s.z*0.5f+0.5f)*float(Height);
+      }
+    });
+
+  Workers::parallelTasks(Bands,[this](uintptr_t band) {
+    const int32_t bandH = Height/Bands;
+    rasterizeBand(int32_t(band)*bandH, int32_t(band+1)*bandH);
+    });
+  ready = true;
+  }
+
+void OcclusionBuffer::rasterizeBand(int32_t y0, int32_t y1) {
+  for(auto& a:active) {
+    auto& occ = *a.occ;
+    auto* id  = &ind[occ.firstInd];
+    auto* sv  = &screen[a.screen];
+    for(uint32_t i=0; i<occ.indCount; i+=3) {
+      auto& v0 = sv[id[i+0]];
+      auto& v1 = sv[id[i+1]];
+      auto& v2 = sv[id[i+2]];
+      if(!v0.valid || !v1.valid || !v2.valid)
+        continue;
+      rasterizeTri(v0,v1,v2,y0,y1);
+      }
+    }
+  }
+
+void OcclusionBuffer::rasterizeTri(ScreenVert a, ScreenVert b, ScreenVert c, int32_t y0, int32_t y1) {
+  // clamp before int-cast: vertices near w==NearW can be far off-screen
+  const float minY = std::clamp(std::min({a.y,b.y,c.y}),-1.f,float(Height));
+  const float maxY = std::clamp(std::max({a.y,b.y,c.y}),-1.f,float(Height));
+  const int32_t py0 = std::max(y0,  int32_t(std::floor(minY)));
+  const int32_t py1 = std::min(y1-1,int32_t(std::ceil (maxY)));
+  if(py0>py1)
+    return;
+
+  const float minX = std::clamp(std::min({a.x,b.x,c.x}),-1.f,float(Width));
+  const float maxX = std::clamp(std::max({a.x,b.x,c.x}),-1.f,float(Width));
+  const int32_t px0 = std::max(0,      int32_t(std::floor(minX)));
+  const int32_t px1 = std::min(Width-1,int32_t(std::ceil (maxX)));
+  if(px0>px1)
+    return;
+
+  float area = (b.x-a.x)*(c.y-a.y) - (b.y-a.y)*(c.x-a.x);
+  if(std::fabs(area)<1e-6f)
+    return;
+  if(area<0) {
+    // rasterize both sides
+    std::swap(b,c);
+    area = -area;
+    }
+
+  // edge functions: e(x,y) = A*x + B*y + C, inside if all >= 0
+  const float A0 = b.y-c.y, B0 = c.x-b.x, C0 = -(A0*b.x + B0*b.y);
+  const float A1 = c.y-a.y, B1 = a.x-c.x, C1 = -(A1*c.x + B1*c.y);
+  const float A2 = a.y-b.y, B2 = b.x-a.x, C2 = -(A2*a.x + B2*a.y);
+
+  // 1/w is affine in screen space
+  const float inv  = 1.f/area;
+  const float Zx   = (A0*a.z + A1*b.z + A2*c.z)*inv;
+  const float Zy   = (B0*a.z + B1*b.z + B2*c.z)*inv;
+  const float Z0   = (C0*a.z + C1*b.z + C2*c.z)*inv;
+  const float zMin = std::min({a.z,b.z,c.z});
+  const float zMax = std::max({a.z,b.z,c.z});
+
+  // conservative: pixel is written only if fully covered (edge functions are evaluated at the worst corner)
+  // and with the farthest depth over its area
+  const float o0 = 0.5f*(std::fabs(A0)+std::fabs(B0));
+  const float o1 = 0.5f*(std::fabs(A1)+std::fabs(B1));
+  const float o2 = 0.5f*(std::fabs(A2)+std::fabs(B2));
+  const float oz = 0.5f*(std::fabs(Zx)+std::fabs(Zy));
+
+  // buffer width is multiple of 4: every lane is a valid pixel of the row
+  const int32_t xBegin = px0 & ~3;
+  for(int32_t y=py0; y<=py1; ++y) {
+    float*      row = &depth[size_t(y*Width)];
+    const float cy  = float(y)+0.5f;
+    const float r0  = B0*cy + C0 - o0;
+    const float r1  = B1*cy + C1 - o1;
+    const float r2  = B2*cy + C2 - o2;
+    const float rz  = Zy*cy + Z0 - oz;
+#if defined(OCCLUSION_SSE2)
+    const __m128 lane = _mm_set_ps(3.5f,2.5f,1.5f,0.5f);
+    const __m128 zero = _mm_setzero_ps();
+    for(int32_t x=xBegin; x<=px1; x+=4) {
+      const __m128 fx = _mm_add_ps(_mm_set1_ps(float(x)),lane);
+      const __m128 e0 = _mm_add_ps(_mm_mul_ps(fx,_mm_set1_ps(A0)),_mm_set1_ps(r0));
+      const __m128 e1 = _mm_add_ps(_mm_mul_ps(fx,_mm_set1_ps(A1)),_mm_set1_ps(r1));
+      const __m128 e2 = _mm_add_ps(_mm_mul_ps(fx,_mm_set1_ps(A2)),_mm_set1_ps(r2));
+      const __m128 in = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0,zero),_mm_cmpge_ps(e1,zero)),_mm_cmpge_ps(e2,zero));
+
+      __m128 z = _mm_add_ps(_mm_mul_ps(fx,_mm_set1_ps(Zx)),_mm_set1_ps(rz));
+      z = _mm_min_ps(_mm_max_ps(z,_mm_set1_ps(zMin)),_mm_set1_ps(zMax));
+
+      const __m128 d  = _mm_loadu_ps(row+x);
+      const __m128 nd = _mm_max_ps(d,z);
+      _mm_storeu_ps(row+x,_mm_or_ps(_mm_and_ps(in,nd),_mm_andnot_ps(in,d)));
+      }
+#elif defined(OCCLUSION_NEON)
+    const float       laneF[4] = {0.5f,1.5f,2.5f,3.5f};
+    const float32x4_t lane     = vld1q_f32(laneF);
+    const float32x4_t zero     = vdupq_n_f32(0);
+    for(int32_t x=xBegin; x<=px1; x+=4) {
+      const float32x4_t fx = vaddq_f32(vdupq_n_f32(float(x)),lane);
+      const float32x4_t e0 = vmlaq_n_f32(vdupq_n_f32(r0),fx,A0);
+      const float32x4_t e1 = vmlaq_n_f32(vdupq_n_f32(r1),fx,A1);
+      const float32x4_t e2 = vmlaq_n_f32(vdupq_n_f32(r2),fx,A2);
+      const uint32x4_t  in = vandq_u32(vandq_u32(vcgeq_f32(e0,zero),vcgeq_f32(e1,zero)),vcgeq_f32(e2,zero));
+
+      float32x4_t z = vmlaq_n_f32(vdupq_n_f32(rz),fx,Zx);
+      z = vminq_f32(vmaxq_f32(z,vdupq_n_f32(zMin)),vdupq_n_f32(zMax));
+
+      const float32x4_t d = vld1q_f32(row+x);
+      vst1q_f32(row+x,vbslq_f32(in,vmaxq_f32(d,z),d));
+      }
+#else
+    for(int32_t x=xBegin; x<=px1; ++x) {
+      const float fx = float(x)+0.5f;
+      if(A0*fx+r0<0 || A1*fx+r1<0 || A2*fx+r2<0)
+        continue;
+      const float z = std::clamp(Zx*fx+rz,zMin,zMax);
+      row[x] = std::max(row[x],z);
+      }
+#endif
+    }
+  }
+
+bool OcclusionBuffer::isVisible(const Vec3& min, const Vec3& max) const {
+  if(!ready)
+    return true;
+
+  float sx0 = float(Width),  sx1 = 0;
+  float sy0 = float(Height), sy1 = 0;
+  float z   = 0;
+  for(int i=0; i<8; ++i) {
+    const float px = (i&1) ? max.x : min.x;
+    const float py = (i&2) ? max.y : min.y;
+    const float pz = (i&4) ? max.z : min.z;
+    const float x  = clip[0]*px + clip[4]*py + clip[ 8]*pz + clip[12];
+    const float y  = clip[1]*px + clip[5]*py + clip[ 9]*pz + clip[13];
+    const float w  = clip[3]*px + clip[7]*py + clip[11]*pz + clip[15];
+    if(!(w>=NearW))
+      return true;
+    const float iw = 1.f/w;
+    const float sx = (x*iw*0.5f+0.5f)*float(Width);
+    const float sy = (y*iw*0.5f+0.5f)*float(Height);
+    sx0 = std::min(sx0,std::max(sx,-1.f));
+    sx1 = std::max(sx1,std::min(sx,float(Width)));
+    sy0 = std::min(sy0,std::max(sy,-1.f));
+    sy1 = std::max(sy1,std::min(sy,float(Height)));
+    z   = std::max(z,iw);
+    }
+
+  const int32_t x0 = std::max(0,       int32_t(std::floor(sx0)));
+  const int32_t x1 = std::min(Width-1, int32_t(std::floor(sx1)));
+  const int32_t y0 = std::max(0,       int32_t(std::floor(sy0)));
+  const int32_t y1 = std::min(Height-1,int32_t(std::floor(sy1)));
+  if(x0>x1 || y0>y1)
+    return true;
+
+  for(int32_t y=y0; y<=y1; ++y) {
+    const float* row = &depth[size_t(y*Width)];
+    for(int32_t x=x0; x<=x1; ++x)
+      if(row[x]<=z)
+        return true;
+    }
+  return false;
+  }
+
+bool OcclusionBuffer::isVisible(const Vec3& pos, float r) const {
+  return isVisible(pos-Vec3(r,r,r),pos+Vec3(r,r,r));
+  }
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Tempest/Vec>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Frustrum;
+class PackedMesh;
+
+// low-resolution cpu depth buffer of large landscape meshlets, to reject hidden objects before gpu submission
+class OcclusionBuffer final {
+  public:
+    enum {
+      Width  = 256,
+      Height = 128,
+      };
+
+    void addOccluders(const PackedMesh& mesh, size_t iboOffset, size_t iboLength);
+    bool hasOccluders() const { return !occluders.empty(); }
+
+    void rasterize(const Frustrum& f);
+
+    // conservative: false only, if world-space box is completely behind rasterized occluders
+    bool isVisible(const Tempest::Vec3& min, const Tempest::Vec3& max) const;
+    bool isVisible(const Tempest::Vec3& pos, float r) const;
+
+  private:
+    static constexpr int32_t Bands        = 8;
+    static constexpr size_t  MaxOccluders = 1024;
+    // meshlets smaller than that are not worth to rasterize
+    static constexpr float   MinOccluderR = 300;
+    // triangles, that cross near plane, are skipped
+    static constexpr float   NearW        = 10;
+
+    struct Occluder {
+      Tempest::Vec3 pos;
+      float         r         = 0;
+      uint32_t      firstVert = 0;
+      uint32_t      firstInd  = 0;
+      uint32_t      indCount  = 0;
+      uint32_t      vertCount = 0;
+      };
+
+    struct Active {
+      const Occluder* occ    = nullptr;
+      float           weight = 0;
+      uint32_t        screen = 0;
+      };
+
+    struct ScreenVert {
+      float x = 0, y = 0;
+      float z = 0; // 1/w
+      bool  valid = false;
+      };
+
+    void rasterizeBand(int32_t y0, int32_t y1);
+    void rasterizeTri (ScreenVert a, ScreenVert b, ScreenVert c, int32_t y0, int32_t y1);
+
+    std::vector<Occluder>      occluders;
+    std::vector<Tempest::Vec3> vert;
+    std::vector<uint8_t>       ind;
+
+    std::vector<Active>        active;
+    std::vector<ScreenVert>    screen;
+
+    float                      clip[16] = {};
+    bool                       ready    = false;
+    // 1/w of nearest occluder; 0 - empty
+    std::vector<float>         depth;
+  };
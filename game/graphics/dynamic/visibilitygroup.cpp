@@ -1,6 +1,7 @@
 #include "visibilitygroup.h"
 
 #include <Tempest/Log>
+#include <limits>
 
 #include "frustrum.h"
 #include "visibleset.h"
@@ -94,6 +95,28 @@ const Bounds& VisibilityGroup::Token::bounds() const {
   return t.bbox;
   }
 
+void VisibilityGroup::Spheres::resize(size_t sz) {
+  x.resize(sz);
+  y.resize(sz);
+  z.resize(sz);
+  r.resize(sz);
+  }
+
+void VisibilityGroup::Spheres::set(size_t i, const Bounds& b) {
+  x[i] = b.midTr.x;
+  y[i] = b.midTr.y;
+  z[i] = b.midTr.z;
+  r[i] = b.r;
+  }
+
+void VisibilityGroup::Spheres::setEmpty(size_t i) {
+  // never passes frustum test
+  x[i] = 0;
+  y[i] = 0;
+  z[i] = 0;
+  r[i] = -std::numeric_limits<float>::infinity();
+  }
+
 VisibilityGroup::VisibilityGroup(const std::pair<Vec3, Vec3>& bbox) {
   def .freeList.reserve(4);
   stat.freeList.reserve(4);
@@ -150,6 +173,16 @@ void VisibilityGroup::buildTree() {
   treeNode.resize(2); // dummy node + root
   buildTree(1,treeTok.data(),treeTok.data()+treeTok.size(),0);
 
+  treeSph.resize(treeTok.size());
+  for(size_t i=0; i<treeTok.size(); ++i) {
+    auto& t = *treeTok[i].self;
+    if(t.updateBbox) {
+      t.bbox.setObjMatrix(t.pos);
+      t.updateBbox = false;
+      }
+    treeSph.set(i,t.bbox);
+    }
+
   uint8_t maxTh = Workers::maxThreads();
   size_t  depth = 1;
 
@@ -272,6 +305,10 @@ void VisibilityGroup::pass(const Frustrum f[]) {
     v->reset();
     });
 
+  useOcclusion = occlusion.hasOccluders();
+  if(useOcclusion)
+    occlusion.rasterize(f[SceneGlobals::V_Main]);
+
   for(auto& t:alwaysVis.tokens) {
     if(t.vSet==nullptr)
       continue;
@@ -282,8 +319,10 @@ void VisibilityGroup::pass(const Frustrum f[]) {
 
   testStaticObjectsThreaded(f);
 
-  Workers::parallelFor(def.tokens,[&f](Tok& t) {
-    testVisibility(t,f);
+  defSph.resize(def.tokens.size());
+  Workers::parallelTasks((def.tokens.size()+BlockSize-1)/BlockSize,[this,&f](uintptr_t block) {
+    const size_t begin = block*BlockSize;
+    testVisibility(f,begin,std::min(begin+BlockSize,def.tokens.size()));
     });
   }
 
@@ -298,6 +337,23 @@ void VisibilityGroup::buildVSetIndex(const std::vector<ObjectsBucket*>& index) {
   std::sort(resetableSets.begin(),resetableSets.end());
   }
 
+void VisibilityGroup::addOccluders(const PackedMesh& mesh, size_t iboOffset, size_t iboLength) {
+  occlusion.addOccluders(mesh,iboOffset,iboLength);
+  }
+
+void VisibilityGroup::objectBounds(std::vector<Bounds>& out) const {
+  for(auto gr:{&def,&stat}) {
+    for(auto& t:gr->tokens) {
+      if(t.vSet==nullptr)
+        continue;
+      Bounds b = t.bbox;
+      if(t.updateBbox)
+        b.setObjMatrix(t.pos);
+      out.push_back(b);
+      }
+    }
+  }
+
 void VisibilityGroup::testStaticObjectsThreaded(const Frustrum f[]) {
   Workers::parallelTasks(treeTasks.size(),[&](uintptr_t taskId) {
     auto& t = treeTasks[taskId];
@@ -319,20 +375,26 @@ void VisibilityGroup::testStaticObjects(const Frustrum f[], SceneGlobals::VisCam
     return;
   auto& n       = treeNode[node];
   auto  visible = f[c].testBbox(n.bbox.bbox[0],n.bbox.bbox[1]);
+  if(visible!=Frustrum::T_Invisible && c==SceneGlobals::V_Main && useOcclusion &&
+     !occlusion.isVisible(n.bbox.bbox[0],n.bbox.bbox[1]))
+    return;
 
   if(n.isLeaf || visible==Frustrum::T_Full) {
     // setVisible(SceneGlobals::VisCamera(c),begin,end);
-    for(auto i=begin; i!=end; ++i) {
-      auto& v = *i->self->vSet;
-      auto& t = *i->self;
-      auto& b = t.bbox;
-      if(t.updateBbox) {
-        t.bbox.setObjMatrix(t.pos);
-        t.updateBbox = false;
+    const size_t b0 = size_t(std::distance(treeTok.data(),begin));
+    const size_t b1 = size_t(std::distance(treeTok.data(),end));
+    uint8_t      mask[BlockSize] = {};
+    for(size_t i=b0; i<b1; i+=BlockSize) {
+      const size_t cnt = std::min(b1-i,size_t(BlockSize));
+      Frustrum::testSpheres(&f[c],1,&treeSph.x[i],&treeSph.y[i],&treeSph.z[i],&treeSph.r[i],cnt,mask);
+      for(size_t r=0; r<cnt; ++r) {
+        if(mask[r]==0)
+          continue;
+        if(c==SceneGlobals::V_Main && useOcclusion && !occlusion.isVisible(treeSph.pos(i+r),treeSph.r[i+r]))
+          continue;
+        auto& t = *treeTok[i+r].self;
+        t.vSet->push(t.id, c);
         }
-      if(!f[c].testPoint(b.midTr, b.r))
-        continue;
-      v.push(i->self->id, c);
       }
     return;
     }
@@ -345,36 +407,34 @@ void VisibilityGroup::testStaticObjects(const Frustrum f[], SceneGlobals::VisCam
   testStaticObjects(f,c, node*2+1, begin+sz/2,end);
   }
 
-void VisibilityGroup::testVisibility(Tok& t, const Frustrum f[]) {
-  auto& b = t.bbox;
-  if(t.vSet==nullptr)
-    return;
-  if(t.updateBbox) {
-    t.bbox.setObjMatrix(t.pos);
-    t.updateBbox = false;
+void VisibilityGroup::testVisibility(const Frustrum f[], size_t begin, size_t end) {
+  for(size_t i=begin; i<end; ++i) {
+    auto& t = def.tokens[i];
+    if(t.vSet==nullptr) {
+      defSph.setEmpty(i);
+      continue;
+      }
+    if(t.updateBbox) {
+      t.bbox.setObjMatrix(t.pos);
+      t.updateBbox = false;
+      }
+    defSph.set(i,t.bbox);
     }
 
-  bool  visible[SceneGlobals::V_Count] = {};
-  float dist   [SceneGlobals::V_Count] = {};
-  visible[SceneGlobals::V_Shadow0] = f[SceneGlobals::V_Shadow0].testPoint(b.midTr, b.r, dist[SceneGlobals::V_Shadow0]);
-  visible[SceneGlobals::V_Shadow1] = f[SceneGlobals::V_Shadow1].testPoint(b.midTr, b.r, dist[SceneGlobals::V_Shadow1]);
-  visible[SceneGlobals::V_Main]    = f[SceneGlobals::V_Main   ].testPoint(b.midTr, b.r, dist[SceneGlobals::V_Main   ]);
-
-  /*
-  if(b.r<1.f*100.f) {
-    static const float farDist = 50*100; // 50 meters
-    if(visible[SceneGlobals::V_Shadow1] && dist[SceneGlobals::V_Shadow1]>b.r+farDist)
-      visible[SceneGlobals::V_Shadow1] = subpixelMeshTest(t,f[SceneGlobals::V_Shadow1],sh1X,sh1Y);
-    if(visible[SceneGlobals::V_Main] && dist[SceneGlobals::V_Main]>b.r+farDist)
-      visible[SceneGlobals::V_Main] = subpixelMeshTest(t,f[SceneGlobals::V_Main],mX,mY);
-    }*/
-
-  if(visible[SceneGlobals::V_Shadow0])
-    t.vSet->push(t.id,SceneGlobals::V_Shadow0);
-  if(visible[SceneGlobals::V_Shadow1])
-    t.vSet->push(t.id,SceneGlobals::V_Shadow1);
-  if(visible[SceneGlobals::V_Main])
-    t.vSet->push(t.id,SceneGlobals::V_Main);
+  uint8_t      mask[BlockSize] = {};
+  const size_t cnt = std::min(end-begin,size_t(BlockSize));
+  Frustrum::testSpheres(f,SceneGlobals::V_Count,&defSph.x[begin],&defSph.y[begin],&defSph.z[begin],&defSph.r[begin],cnt,mask);
+
+  for(size_t i=0; i<cnt; ++i) {
+    if(mask[i]==0)
+      continue;
+    auto& t = def.tokens[begin+i];
+    if((mask[i] & (1u<<SceneGlobals::V_Main)) && useOcclusion && !occlusion.isVisible(defSph.pos(begin+i),defSph.r[begin+i]))
+      mask[i] &= uint8_t(~(1u<<SceneGlobals::V_Main));
+    for(uint8_t c=SceneGlobals::V_Shadow0; c<SceneGlobals::V_Count; ++c)
+      if(mask[i] & (1u<<c))
+        t.vSet->push(t.id,SceneGlobals::VisCamera(c));
+    }
   }
 
 bool VisibilityGroup::subpixelMeshTest(const Tok& t, const Frustrum& f, float edgeX, float edgeY) {
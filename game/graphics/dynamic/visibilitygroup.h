@@ -5,10 +5,12 @@
 
 #include "graphics/sceneglobals.h"
 #include "graphics/bounds.h"
+#include "occlusionbuffer.h"
 
 class Frustrum;
 class VisibleSet;
 class ObjectsBucket;
+class PackedMesh;
 
 class VisibilityGroup {
   private:
@@ -49,6 +51,11 @@ class VisibilityGroup {
     Token get(Group g);
     void  pass(const Frustrum f[]);
     void  buildVSetIndex(const std::vector<ObjectsBucket*>& index);
+    void  addOccluders(const PackedMesh& mesh, size_t iboOffset, size_t iboLength);
+
+    // for offline culling replay in headless benchmark
+    auto  occluders() const -> const OcclusionBuffer& { return occlusion; }
+    void  objectBounds(std::vector<Bounds>& out) const;
 
   private:
     struct Tok {
@@ -80,11 +87,27 @@ class VisibilityGroup {
       TreeItm* end   = nullptr;
       size_t   node  = 0;
       };
+    enum {
+      BlockSize = 256,
+      };
+
+    // bounding spheres, packed for Frustrum::testSpheres
+    struct Spheres {
+      std::vector<float> x, y, z, r;
+      void resize(size_t sz);
+      void set(size_t i, const Bounds& b);
+      void setEmpty(size_t i);
+      auto pos(size_t i) const -> Tempest::Vec3 { return Tempest::Vec3(x[i],y[i],z[i]); }
+      };
     std::vector<Node>        treeNode;
     std::vector<TreeItm>     treeTok;
     std::vector<TreeTask>    treeTasks;
+    Spheres                  treeSph;
+    Spheres                  defSph;
 
     std::vector<VisibleSet*> resetableSets;
+    OcclusionBuffer          occlusion;
+    bool                     useOcclusion = false;
 
     bool                     updateThree = false;
 
@@ -98,7 +121,7 @@ class VisibilityGroup {
     void        testStaticObjectsThreaded(const Frustrum f[]);
     void        testStaticObjects(const Frustrum f[], SceneGlobals::VisCamera c,
                                   size_t node, TreeItm* begin, TreeItm* end);
-    static void testVisibility(Tok& t, const Frustrum f[]);
+    void        testVisibility(const Frustrum f[], size_t begin, size_t end);
     static bool subpixelMeshTest(const Tok& t, const Frustrum& f, float edgeX, float edgeY);
   };
 
@@ -1,41 +1,58 @@
 #include "visibleset.h"
 
+#include <algorithm>
+#include <cassert>
+
 VisibleSet::VisibleSet() {
   }
 
+void VisibleSet::reserve(size_t capacity) {
+  // must not be called during visibility pass
+  for(auto& c:cam)
+    if(c.id.size()<capacity)
+      c.id.resize(capacity);
+  }
+
 void VisibleSet::reset() {
-  for(auto& i:cnt)
-    i.store(0);
+  for(auto& c:cam)
+    c.cnt.store(0,std::memory_order_relaxed);
   }
 
 void VisibleSet::push(size_t index, SceneGlobals::VisCamera v) {
-  int i = cnt[v].fetch_add(1, std::memory_order_acq_rel);
-  id[v][i] = index;
+  auto& c = cam[v];
+  auto  i = c.cnt.fetch_add(1, std::memory_order_relaxed);
+  assert(i<c.id.size());
+  c.id[i] = uint32_t(index);
   }
 
 void VisibleSet::erase(size_t objId) {
-  for(size_t v=0; v<SceneGlobals::V_Count; ++v) {
-    size_t count = size_t(cnt[v].load());
-    for(size_t i=0; i<count; ++i) {
-      if(id[v][i]!=objId)
+  for(auto& c:cam) {
+    size_t count = size_t(c.cnt.load());
+    for(size_t i=0; i<count; ) {
+      if(c.id[i]!=objId) {
+        ++i;
         continue;
-      id[v][i] = id[v][count-1];
+        }
+      c.id[i] = c.id[count-1];
       count--;
       }
-    cnt[v].store(std::uint_least8_t(count));
+    c.cnt.store(uint32_t(count));
     }
   }
 
 void VisibleSet::sort(SceneGlobals::VisCamera v) {
-  uint8_t indSz = uint8_t(cnt[v].load());
-  size_t* index = id[v];
-  std::sort(index,index+indSz);
+  auto& c     = cam[v];
+  auto  indSz = c.cnt.load();
+  std::sort(c.id.begin(),c.id.begin()+indSz);
   }
 
 void VisibleSet::minmax(SceneGlobals::VisCamera v) {
-  uint8_t indSz = uint8_t(cnt[v].load());
-  size_t* index = id[v];
-  size_t& last  = index[indSz-1];
+  auto&     c     = cam[v];
+  auto      indSz = size_t(c.cnt.load());
+  uint32_t* index = c.id.data();
+  if(indSz==0)
+    return;
+  uint32_t& last  = index[indSz-1];
 
   for(size_t i=0; i<indSz; ++i) {
     if(index[0]>index[i])
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <atomic>
+#include <vector>
 
 #include "graphics/sceneglobals.h"
 
@@ -9,22 +10,22 @@ class VisibleSet {
   public:
     VisibleSet();
 
-    enum {
-      CAPACITY     = 255,
-      };
-
+    void reserve(size_t capacity);
     void reset();
     void push(size_t id, SceneGlobals::VisCamera v);
 
-    size_t        count(SceneGlobals::VisCamera v) const { return size_t(cnt[v].load()); }
-    const size_t* index(SceneGlobals::VisCamera v) const { return id[v];                 }
+    size_t          count(SceneGlobals::VisCamera v) const { return size_t(cam[v].cnt.load(std::memory_order_relaxed)); }
+    const uint32_t* index(SceneGlobals::VisCamera v) const { return cam[v].id.data(); }
 
-    void          erase(size_t id);
-    void          sort(SceneGlobals::VisCamera v);
-    void          minmax(SceneGlobals::VisCamera v);
+    void            erase(size_t id);
+    void            sort(SceneGlobals::VisCamera v);
+    void            minmax(SceneGlobals::VisCamera v);
 
   private:
-    std::atomic_uint_least8_t cnt[SceneGlobals::V_Count]           = {};
-    size_t                    id [SceneGlobals::V_Count][CAPACITY] = {};
+    // own cache-line per camera: shadow and main passes are pushed from different workers
+    struct alignas(64) Camera {
+      std::atomic_uint32_t  cnt{0};
+      std::vector<uint32_t> id;
+      };
+    Camera cam[SceneGlobals::V_Count];
   };
-
@@ -469,7 +469,7 @@ bool MdlVisual::isUsingTorch() const {
   return torch.view!=nullptr;
   }
 
-bool MdlVisual::updateAnimation(Npc* npc, World& world, uint64_t dt) {
+bool MdlVisual::updateAnimation(Npc* npc, World& world, uint64_t dt, bool sample) {
   Pose&    pose      = *skInst;
   uint64_t tickCount = world.tickCount();
   auto     pos3      = Vec3{pos.at(3,0), pos.at(3,1), pos.at(3,2)};
@@ -491,7 +491,7 @@ bool MdlVisual::updateAnimation(Npc* npc, World& world, uint64_t dt) {
 
   solver.update(tickCount);
   pose.setObjectMatrix(pos,false);
-  const bool changed = pose.update(tickCount);
+  const bool changed = sample ? pose.update(tickCount) : pose.hold(tickCount);
 
   if(changed)
     view.setPose(pos,pose);
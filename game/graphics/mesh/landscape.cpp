@@ -28,6 +28,10 @@ Landscape::Landscape(VisualObjects& visual, const PackedMesh &packed)
       mesh.sub[i].blas = device.blas(mesh.vbo,mesh.ibo,sub.iboOffset,sub.iboLength);
       }
 
+    if(Gothic::options().doSoftwareOcclusion && material.alpha==Material::Solid) {
+      visual.addOccluders(packed,sub.iboOffset,sub.iboLength);
+      }
+
     Bounds bbox;
     bbox.assign(packed.vertices,packed.indices,sub.iboOffset,sub.iboLength);
 
@@ -307,6 +307,11 @@ void Pose::processLayers(AnimationSolver& solver, uint64_t tickCount) {
   }
 
 bool Pose::update(uint64_t tickCount) {
+  // held pose has to be resampled, even if hold() was called on same tick
+  const bool sample = (lastUpdate!=tickCount || needToSample);
+  needToUpdate |= needToSample;
+  needToSample  = false;
+
   if(lay.size()==0) {
     const bool ret = needToUpdate;
     if(needToUpdate || lastUpdate==0)
@@ -316,7 +321,7 @@ bool Pose::update(uint64_t tickCount) {
     return ret;
     }
 
-  if(lastUpdate!=tickCount) {
+  if(sample) {
     for(auto& i:lay) {
       const Animation::Sequence* seq = i.seq;
       if(0<i.comb && i.comb<=i.seq->comb.size()) {
@@ -336,6 +341,17 @@ bool Pose::update(uint64_t tickCount) {
   return false;
   }
 
+bool Pose::hold(uint64_t tickCount) {
+  // sfx/pfx windows start at lastUpdate - keep them in sync with real time
+  lastUpdate = tickCount;
+  if(!needToUpdate)
+    return false;
+  mkSkeleton(pos);
+  needToUpdate = false;
+  needToSample = true;
+  return true;
+  }
+
 bool Pose::updateFrame(const Animation::Sequence &s, BodyState bs, uint64_t sBlend,
                        uint64_t barrier, uint64_t sTime, uint64_t now) {
   auto&        d         = *s.data;
@@ -49,6 +49,8 @@ class Pose final {
 
     void               setObjectMatrix(const Tempest::Matrix4x4& obj, bool sync);
     bool               update(uint64_t tickCount);
+    // advance time without sampling animation: skeleton only follows object matrix
+    bool               hold(uint64_t tickCount);
 
     void               processLayers(AnimationSolver &solver, uint64_t tickCount);
     bool               processEvents(uint64_t& barrier, uint64_t now, Animation::EvCount &ev) const;
@@ -141,6 +143,7 @@ class Pose final {
     uint64_t                        lastUpdate=0;
     ComboState                      combo;
     bool                            needToUpdate = true;
+    bool                            needToSample = false;
     uint8_t                         hasEvents = 0;
     uint8_t                         isFlyCombined = 0;
     uint8_t                         hasTransitions = 0;
@@ -253,13 +253,19 @@ const void* ObjectsBucket::meshPointer() const {
 
 ObjectsBucket::Object& ObjectsBucket::implAlloc(const Bounds& bounds, const Material& /*mat*/) {
   Object* v = nullptr;
-  for(size_t i=0; i<CAPACITY; ++i) {
+  for(size_t i=0; i<val.size(); ++i) {
     auto& vx = val[i];
     if(vx.isValid)
       continue;
     v = &vx;
     break;
     }
+  if(v==nullptr) {
+    // buckets are filled up to capacity() by VisualObjects::getBucket
+    val.emplace_back();
+    v = &val.back();
+    visSet.reserve(val.size());
+    }
 
   if(valSz==0)
     owner.resetIndex();
@@ -276,11 +282,11 @@ ObjectsBucket::Object& ObjectsBucket::implAlloc(const Bounds& bounds, const Mate
   else
     v->visibility = owner.visGroup.get(VisibilityGroup::G_Default);
   v->visibility.setBounds(bounds);
-  v->visibility.setObject(&visSet,size_t(std::distance(val,v)));
+  v->visibility.setObject(&visSet,size_t(std::distance(val.data(),v)));
   v->skiningAni = nullptr;
   v->isValid    = true;
 
-  valLen = std::max(valLen, size_t(std::distance(val,v)+1));
+  valLen = std::max(valLen, size_t(std::distance(val.data(),v)+1));
   reallocObjPositions();
 
   return *v;
@@ -316,7 +322,7 @@ void ObjectsBucket::implFree(const size_t objId) {
   visSet.erase(objId);
 
   valLen = 0;
-  for(size_t i=CAPACITY; i>1; --i)
+  for(size_t i=val.size(); i>0; --i)
     if(val[i-1].isValid) {
       valLen = i;
       break;
@@ -457,7 +463,7 @@ void ObjectsBucket::invalidateUbo(uint8_t fId) {
   }
 
 void ObjectsBucket::fillTlas(RtScene& out) {
-  for(size_t i=0; i<CAPACITY; ++i) {
+  for(size_t i=0; i<val.size(); ++i) {
     auto& v = val[i];
     if(!v.isValid || v.blas==nullptr)
       continue;
@@ -465,7 +471,7 @@ void ObjectsBucket::fillTlas(RtScene& out) {
     }
   }
 
-void ObjectsBucket::preFrameUpdateWind(uint8_t fId, const bool* upd) {
+void ObjectsBucket::preFrameUpdateWind(uint8_t fId, const uint8_t* upd) {
   if(!windAnim || !scene.zWindEnabled)
     return;
   for(size_t i=0; i<valLen; ++i) {
@@ -505,7 +511,7 @@ void ObjectsBucket::preFrameUpdateWind(uint8_t fId, const bool* upd) {
     }
   }
 
-void ObjectsBucket::preFrameUpdateMorph(uint8_t fId, const bool* upd) {
+void ObjectsBucket::preFrameUpdateMorph(uint8_t fId, const uint8_t* upd) {
   if(objType!=Morph)
     return;
   for(size_t i=0; i<valLen; ++i) {
@@ -542,17 +548,21 @@ void ObjectsBucket::preFrameUpdate(uint8_t fId) {
   if((!windAnim || !scene.zWindEnabled) && objType!=Morph)
     return;
 
-  bool upd[CAPACITY] = {};
+  auto upd = visibleMask();
+  preFrameUpdateWind (fId, upd);
+  preFrameUpdateMorph(fId, upd);
+  }
+
+const uint8_t* ObjectsBucket::visibleMask() {
+  visMask.assign(val.size(),0);
   for(uint8_t ic=0; ic<SceneGlobals::V_Count; ++ic) {
-    const auto    c     = SceneGlobals::VisCamera(ic);
-    const size_t  indSz = visSet.count(c);
-    const size_t* index = visSet.index(c);
+    const auto      c     = SceneGlobals::VisCamera(ic);
+    const size_t    indSz = visSet.count(c);
+    const uint32_t* index = visSet.index(c);
     for(size_t i=0; i<indSz; ++i)
-      upd[index[i]] = true;
+      visMask[index[i]] = 1;
     }
-
-  preFrameUpdateWind (fId, upd);
-  preFrameUpdateMorph(fId, upd);
+  return visMask.data();
   }
 
 size_t ObjectsBucket::alloc(const StaticMesh& mesh, size_t iboOffset, size_t iboLen,
@@ -573,8 +583,8 @@ size_t ObjectsBucket::alloc(const StaticMesh& mesh, size_t iboOffset, size_t ibo
       owner.notifyTlas(mat, toRtCategory(objType));
       }
     }
-  postAlloc(*v,size_t(std::distance(val,v)));
-  return size_t(std::distance(val,v));
+  postAlloc(*v,size_t(std::distance(val.data(),v)));
+  return size_t(std::distance(val.data(),v));
   }
 
 size_t ObjectsBucket::alloc(const AnimMesh& mesh, size_t iboOffset, size_t iboLen,
@@ -584,7 +594,7 @@ size_t ObjectsBucket::alloc(const AnimMesh& mesh, size_t iboOffset, size_t iboLe
   v->iboLength  = iboLen;
   v->skiningAni = &anim;
 
-  const auto id = size_t(std::distance(val,v));
+  const auto id = size_t(std::distance(val.data(),v));
   postAlloc(*v,id);
   return id;
   }
@@ -592,8 +602,8 @@ size_t ObjectsBucket::alloc(const AnimMesh& mesh, size_t iboOffset, size_t iboLe
 size_t ObjectsBucket::alloc(const Bounds& bounds) {
   Object* v = &implAlloc(bounds,mat);
   v->visibility.setGroup(VisibilityGroup::G_AlwaysVis);
-  postAlloc(*v,size_t(std::distance(val,v)));
-  return size_t(std::distance(val,v));
+  postAlloc(*v,size_t(std::distance(val.data(),v)));
+  return size_t(std::distance(val.data(),v));
   }
 
 void ObjectsBucket::free(const size_t objId) {
@@ -623,8 +633,8 @@ void ObjectsBucket::drawHiZ(Tempest::Encoder<Tempest::CommandBuffer>& /*cmd*/, u
 
 void ObjectsBucket::drawCommon(Encoder<CommandBuffer>& cmd, uint8_t fId, const RenderPipeline& shader,
                                SceneGlobals::VisCamera c, bool isHiZPass) {
-  const size_t  indSz = visSet.count(c);
-  const size_t* index = visSet.index(c);
+  const size_t    indSz = visSet.count(c);
+  const uint32_t* index = visSet.index(c);
   if(indSz==0)
     return;
 
@@ -825,7 +835,7 @@ void ObjectsBucket::reallocObjPositions() {
     return;
 
   windAnim = false;
-  for(size_t i=0; i<CAPACITY; ++i) {
+  for(size_t i=0; i<val.size(); ++i) {
     auto& vx = val[i];
     if(vx.isValid && vx.wind!=phoenix::animation_mode::none) {
       windAnim = true;
@@ -850,7 +860,7 @@ void ObjectsBucket::invalidateInstancing() {
     return;
     }
   Object* pref = nullptr;
-  for(size_t i=0; instancingType!=NoInstancing && i<CAPACITY; ++i) {
+  for(size_t i=0; instancingType!=NoInstancing && i<val.size(); ++i) {
     auto& vx = val[i];
     if(!vx.isValid)
       continue;
@@ -872,7 +882,7 @@ void ObjectsBucket::invalidateInstancing() {
     }
   }
 
-uint32_t ObjectsBucket::applyInstancing(size_t& i, const size_t* index, size_t indSz) const {
+uint32_t ObjectsBucket::applyInstancing(size_t& i, const uint32_t* index, size_t indSz) const {
   if(instancingType==NoInstancing) {
     return 1;
     }
@@ -939,15 +949,7 @@ void ObjectsBucketDyn::preFrameUpdate(uint8_t fId) {
   if(!hasDynMaterials)
     return;
 
-  bool upd[CAPACITY] = {};
-  for(uint8_t ic=0; ic<SceneGlobals::V_Count; ++ic) {
-    const auto    c     = SceneGlobals::VisCamera(ic);
-    const size_t  indSz = visSet.count(c);
-    const size_t* index = visSet.index(c);
-    for(size_t i=0; i<indSz; ++i)
-      upd[index[i]] = true;
-    }
-
+  auto upd = visibleMask();
   for(size_t i=0; i<valLen; ++i) {
     if(!upd[i])
       continue;
@@ -959,7 +961,7 @@ void ObjectsBucketDyn::preFrameUpdate(uint8_t fId) {
 ObjectsBucket::Object& ObjectsBucketDyn::implAlloc(const Bounds& bounds, const Material& m) {
   auto& obj = ObjectsBucket::implAlloc(bounds,m);
 
-  const size_t id = size_t(std::distance(val,&obj));
+  const size_t id = size_t(std::distance(val.data(),&obj));
   uboObj   [id].alloc(*this);
   mat      [id] = m;
   bucketObj[id] = allocBucketDesc(bounds, mat[id]);
@@ -1013,7 +1015,7 @@ const Material& ObjectsBucketDyn::material(size_t i) const {
 void ObjectsBucketDyn::prepareUniforms() {
   ObjectsBucket::prepareUniforms();
 
-  for(size_t i=0; i<CAPACITY; ++i) {
+  for(size_t i=0; i<CAPACITY_DYN; ++i) {
     uboSetCommon(uboObj[i],mat[i],bucketObj[i]);
     }
 
@@ -1037,7 +1039,7 @@ void ObjectsBucketDyn::invalidateUbo(uint8_t fId) {
   }
 
 void ObjectsBucketDyn::fillTlas(RtScene& out) {
-  for(size_t i=0; i<CAPACITY; ++i) {
+  for(size_t i=0; i<val.size(); ++i) {
     auto& v = val[i];
     if(!v.isValid || v.blas==nullptr)
       continue;
@@ -1047,7 +1049,7 @@ void ObjectsBucketDyn::fillTlas(RtScene& out) {
 
 void ObjectsBucketDyn::invalidateDyn() {
   hasDynMaterials = false;
-  for(size_t i=0; i<CAPACITY; ++i) {
+  for(size_t i=0; i<val.size(); ++i) {
     auto& v = val[i];
     if(!v.isValid)
       continue;
@@ -1058,8 +1060,8 @@ void ObjectsBucketDyn::invalidateDyn() {
 void ObjectsBucketDyn::drawCommon(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId,
                                   const Tempest::RenderPipeline& shader,
                                   SceneGlobals::VisCamera c, bool isHiZPass) {
-  const size_t  indSz = visSet.count(c);
-  const size_t* index = visSet.index(c);
+  const size_t    indSz = visSet.count(c);
+  const uint32_t* index = visSet.index(c);
   if(indSz==0)
     return;
 
@@ -28,7 +28,9 @@ class ObjectsBucket {
 
   public:
     enum {
-      CAPACITY = VisibleSet::CAPACITY,
+      CAPACITY     = 4096,
+      // dynamic buckets keep descriptor-set per object
+      CAPACITY_DYN = 255,
       };
 
     enum Type : uint8_t {
@@ -105,6 +107,7 @@ class ObjectsBucket {
     const Tempest::RenderPipeline* pso() const { return pMain; }
 
     size_t                    size()          const { return valSz;      }
+    virtual size_t            capacity()      const { return CAPACITY;   }
     size_t                    alloc(const StaticMesh& mesh, size_t iboOffset, size_t iboLen, const Bounds& bounds,
                                     const Material& mat);
     size_t                    alloc(const AnimMesh& mesh, size_t iboOffset, size_t iboLen,
@@ -116,8 +119,9 @@ class ObjectsBucket {
     virtual void              invalidateUbo(uint8_t fId);
     virtual void              fillTlas(RtScene& out);
 
-    void                      preFrameUpdateWind (uint8_t fId, const bool* upd);
-    void                      preFrameUpdateMorph(uint8_t fId, const bool* upd);
+    void                      preFrameUpdateWind (uint8_t fId, const uint8_t* upd);
+    void                      preFrameUpdateMorph(uint8_t fId, const uint8_t* upd);
+    const uint8_t*            visibleMask();
     virtual void              preFrameUpdate(uint8_t fId);
     virtual void              drawHiZ    (Tempest::Encoder<Tempest::CommandBuffer> &cmd, uint8_t fId);
     void                      draw       (Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId);
@@ -244,7 +248,7 @@ class ObjectsBucket {
     void                      updateInstance(size_t instance, const Object& v);
     void                      reallocObjPositions();
     void                      invalidateInstancing();
-    uint32_t                  applyInstancing(size_t& i, const size_t* index, size_t indSz) const;
+    uint32_t                  applyInstancing(size_t& i, const uint32_t* index, size_t indSz) const;
 
     virtual Descriptors&      objUbo(size_t objId);
     virtual void              drawCommon(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId,
@@ -266,7 +270,8 @@ class ObjectsBucket {
     Descriptors               uboShared;
     VisibleSet                visSet;
 
-    Object                    val[CAPACITY];
+    std::vector<Object>       val;
+    std::vector<uint8_t>      visMask;
     size_t                    valSz  = 0; // count
     size_t                    valLen = 0; // last valid index
     InstanceStorage::Id       objInstances;
@@ -297,6 +302,7 @@ class ObjectsBucketDyn : public ObjectsBucket {
                      const StaticMesh* st, const AnimMesh* anim, const Tempest::StorageBuffer* desc);
 
     void         preFrameUpdate(uint8_t fId) override;
+    size_t       capacity() const override { return CAPACITY_DYN; }
 
   private:
     Object&      implAlloc(const Bounds& bounds, const Material& mat) override;
@@ -316,10 +322,10 @@ class ObjectsBucketDyn : public ObjectsBucket {
                             const Tempest::RenderPipeline& shader, SceneGlobals::VisCamera c, bool isHiZPass) override;
     void         drawHiZ   (Tempest::Encoder<Tempest::CommandBuffer> &cmd, uint8_t fId) override;
 
-    Descriptors  uboObj   [CAPACITY];
+    Descriptors  uboObj   [CAPACITY_DYN];
 
-    Material     mat      [CAPACITY];
-    Bucket       bucketObj[CAPACITY];
+    Material     mat      [CAPACITY_DYN];
+    Bucket       bucketObj[CAPACITY_DYN];
     bool         hasDynMaterials = false;
 
     const Tempest::RenderPipeline* pHiZ = nullptr;
@@ -16,7 +16,7 @@ VisualObjects::~VisualObjects() {
 ObjectsBucket& VisualObjects::getBucket(ObjectsBucket::Type type, const Material& mat,
                                         const StaticMesh* st, const AnimMesh* anim, const StorageBuffer* desc) {
   for(auto& i:buckets)
-    if(i->size()<ObjectsBucket::CAPACITY && i->isCompatible(type,mat,st,anim,desc))
+    if(i->size()<i->capacity() && i->isCompatible(type,mat,st,anim,desc))
       return *i;
   buckets.emplace_back(ObjectsBucket::mkBucket(type,mat,*this,globals,st,anim,desc));
   return *buckets.back();
@@ -99,6 +99,10 @@ void VisualObjects::visibilityPass(const Frustrum fr[]) {
   visGroup.pass(fr);
   }
 
+void VisualObjects::addOccluders(const PackedMesh& mesh, size_t iboOffset, size_t iboLength) {
+  visGroup.addOccluders(mesh,iboOffset,iboLength);
+  }
+
 void VisualObjects::drawTranslucent(Tempest::Encoder<Tempest::CommandBuffer>& enc, uint8_t fId) {
   for(size_t i=lastSolidBucket;i<index.size();++i) {
     auto c = index[i];
@@ -9,6 +9,7 @@ class RtScene;
 class Landscape;
 class Sky;
 class AnimMesh;
+class PackedMesh;
 
 class VisualObjects final {
   public:
@@ -36,6 +37,8 @@ class VisualObjects final {
     void postFrameupdate();
 
     void visibilityPass (const Frustrum fr[]);
+    void addOccluders   (const PackedMesh& mesh, size_t iboOffset, size_t iboLength);
+    auto visibility() const -> const VisibilityGroup& { return visGroup; }
 
     void drawTranslucent(Tempest::Encoder<Tempest::CommandBuffer>& enc, uint8_t fId);
     void drawWater      (Tempest::Encoder<Tempest::CommandBuffer>& enc, uint8_t fId);
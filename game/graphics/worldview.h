@@ -70,6 +70,7 @@ class WorldView {
 
     const SceneGlobals&  sceneGlobals() const { return sGlobal; }
     const Sky&           sky() const { return gSky; }
+    const VisualObjects& visualObjects() const { return visuals; }
 
   private:
     const World&  owner;
@@ -20,6 +20,7 @@
 
 #include "utils/crashlog.h"
 #include "mainwindow.h"
+#include "benchmark.h"
 #include "gothic.h"
 #include "build.h"
 #include "commandline.h"
@@ -120,6 +121,13 @@ int main(int argc,const char** argv) {
   GameMusic            music;
   gothic.setupGlobalScripts();
 
+  if(cmd.isHeadless()) {
+    // fixed-step simulation without window and swapchain
+    music.setEnabled(false);
+    Benchmark bench{cmd.headlessTicks(),cmd.headlessDt()};
+    return bench.exec();
+    }
+
   MainWindow           wx(device);
   Tempest::Application app;
   return app.exec();
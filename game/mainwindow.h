@@ -69,8 +69,6 @@ class MainWindow : public Tempest::Window {
     void drawBar(Tempest::Painter& p, const Tempest::Texture2d *bar, int x, int y, float v, Tempest::AlignFlag flg);   
     void drawProgress(Tempest::Painter& p, int x, int y, int w, int h, float v);
     void drawLoading (Tempest::Painter& p,int x,int y,int w,int h);
-    void drawSaving  (Tempest::Painter& p);
-    void drawSaving  (Tempest::Painter& p, int w, int h, float scale);
 
     void startGame(std::string_view slot);
     void loadGame (std::string_view slot);
@@ -134,8 +132,6 @@ class MainWindow : public Tempest::Window {
 
     const Tempest::Texture2d* focusImg=nullptr;
 
-    const Tempest::Texture2d* saveback=nullptr;
-
     bool                      mouseP[Tempest::MouseEvent::ButtonBack]={};
 
     KeyCodec                  keycodec;
@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <cctype>
 
+#include <Tempest/Log>
+
 #include "utils/string_frm.h"
 #include "world/objects/npc.h"
 #include "world/triggers/abstracttrigger.h"
@@ -130,6 +132,8 @@ Marvin::Marvin() {
     {"insert %c",                  C_Insert},
 
     {"toggle gi",                  C_ToggleGI},
+    {"toggle scriptprof",          C_ToggleScriptProf},
+    {"scriptprof dump",            C_ScriptProfDump},
     };
   }
 
@@ -368,6 +372,21 @@ bool Marvin::exec(std::string_view v) {
     case C_ToggleGI:
       Gothic::inst().toggleGi();
       return true;
+    case C_ToggleScriptProf: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      auto& prof = world->script().profiler();
+      prof.setEnabled(!prof.isEnabled());
+      print(prof.isEnabled() ? "script profiler on" : "script profiler off");
+      return true;
+      }
+    case C_ScriptProfDump: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      return dumpScriptProfile(*world);
+      }
     }
 
   return true;
@@ -445,6 +464,20 @@ bool Marvin::setTime(World& world, std::string_view hh, std::string_view mm) {
   return true;
   }
 
+bool Marvin::dumpScriptProfile(World& world) {
+  auto& prof = world.script().profiler();
+  auto  rep  = prof.report(size_t(-1));
+  for(size_t i=0; i<rep.size(); ++i) {
+    Tempest::Log::i(rep[i]);
+    if(i<16)
+      print(rep[i]);
+    }
+  if(!prof.saveTrace("scriptprof.json"))
+    return false;
+  print("trace saved to scriptprof.json");
+  return true;
+  }
+
 std::string_view Marvin::completeInstanceName(std::string_view inp, bool& fullword) const {
   World* world  = Gothic::inst().world();
   if(world==nullptr || inp.size()==0)
@@ -50,6 +50,8 @@ class Marvin {
 
       // opengothic specific
       C_ToggleGI,
+      C_ToggleScriptProf,
+      C_ScriptProfDump,
       };
 
     struct Cmd {
@@ -76,6 +78,7 @@ class Marvin {
     bool   addItemOrNpcBySymbolName(World* world, std::string_view name, const Tempest::Vec3& at);
     bool   printVariable           (World* world, std::string_view name);
     bool   setTime                 (World& world, std::string_view hh, std::string_view mm);
+    bool   dumpScriptProfile       (World& world);
 
     std::vector<Cmd> cmd;
   };
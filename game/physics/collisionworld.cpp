@@ -41,12 +41,15 @@ struct CollisionWorld::Broadphase : btDbvtBroadphase {
 
   Broadphase() {
     m_deferedcollide = true;
-    rayTestStk.reserve(btDbvt::DOUBLE_STACKSIZE);
     }
 
   void rayTest(const btVector3& rayFrom, const btVector3& rayTo, btBroadphaseRayCallback& rayCallback,
                const btVector3& aabbMin, const btVector3& aabbMax) {
     BroadphaseRayTester callback(rayCallback);
+    // traversal stack is per thread: ray-queries are allowed to run concurrently
+    static thread_local btAlignedObjectArray<const btDbvtNode*> rayTestStk;
+    if(rayTestStk.capacity()==0)
+      rayTestStk.reserve(btDbvt::DOUBLE_STACKSIZE);
     btAlignedObjectArray<const btDbvtNode*>* stack = &rayTestStk;
 
     m_sets[0].rayTestInternal(m_sets[0].m_root,
@@ -71,8 +74,6 @@ struct CollisionWorld::Broadphase : btDbvtBroadphase {
         *stack,
         callback);
     }
-
-  btAlignedObjectArray<const btDbvtNode*> rayTestStk;
   };
 
 struct CollisionWorld::ContructInfo {
@@ -7,11 +7,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <future>
 
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "world/objects/item.h"
 #include "world/bullet.h"
 #include "world/world.h"
+#include "utils/workers.h"
 
 const float DynamicWorld::ghostPadding=50-22.5f;
 const float DynamicWorld::ghostHeight =140;
@@ -607,6 +609,54 @@ DynamicWorld::RayQueryResult DynamicWorld::rayNpc(const Tempest::Vec3& from, con
   return r;
   }
 
+template<class F>
+static void forEachRay(size_t count, const F& f) {
+  // small batches are not worth to wake up workers
+  static const size_t chunk = 32;
+  if(count<=chunk) {
+    for(size_t i=0; i<count; ++i)
+      f(i);
+    return;
+    }
+  const size_t tasks = (count+chunk-1)/chunk;
+  Workers::parallelTasks(tasks,[&f,count](uintptr_t id){
+    const size_t b = size_t(id)*chunk;
+    const size_t e = std::min(b+chunk,count);
+    for(size_t i=b; i<e; ++i)
+      f(i);
+    });
+  }
+
+void DynamicWorld::soundOclusionBatch(std::span<const RayQuery> q, std::span<float> out) const {
+  const size_t count = std::min(q.size(),out.size());
+  forEachRay(count,[&](size_t i){
+    out[i] = soundOclusion(q[i].from,q[i].to);
+    });
+  }
+
+void DynamicWorld::landRayBatch(std::span<const Tempest::Vec3> from, std::span<RayLandResult> out, float maxDy) const {
+  world->updateAabbs();
+  if(maxDy==0)
+    maxDy = worldHeight;
+
+  const size_t count = std::min(from.size(),out.size());
+  auto job = [&](size_t b, size_t e) {
+    for(size_t i=b; i<e; ++i) {
+      auto& p = from[i];
+      out[i] = ray(Tempest::Vec3(p.x,p.y+ghostPadding,p.z), Tempest::Vec3(p.x,p.y-maxDy,p.z));
+      }
+    };
+
+  const size_t th   = std::min<size_t>(Workers::maxThreads(),(count+255)/256);
+  const size_t step = th>0 ? (count+th-1)/th : 0;
+  std::vector<std::future<void>> fut;
+  for(size_t i=1; i<th; ++i)
+    fut.emplace_back(std::async(std::launch::async,job,i*step,std::min(count,(i+1)*step)));
+  job(0,std::min(count,step));
+  for(auto& f:fut)
+    f.get();
+  }
+
 float DynamicWorld::soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
   struct CallBack:btCollisionWorld::AllHitsRayResultCallback {
     using AllHitsRayResultCallback::AllHitsRayResultCallback;
@@ -5,6 +5,7 @@
 #include <Tempest/Matrix4x4>
 #include <memory>
 #include <limits>
+#include <span>
 
 class btTriangleIndexVertexArray;
 class btCollisionShape;
@@ -149,6 +150,11 @@ class DynamicWorld final {
       Npc* npcHit = nullptr;
       };
 
+    struct RayQuery {
+      Tempest::Vec3 from = {};
+      Tempest::Vec3 to   = {};
+      };
+
     struct BulletCallback {
       virtual ~BulletCallback()=default;
       virtual void onStop(){}
@@ -233,6 +239,11 @@ class DynamicWorld final {
     RayQueryResult rayNpc       (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     float          soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
 
+    // batched queries: fan out over Workers, so main thread only
+    void           soundOclusionBatch(std::span<const RayQuery> q, std::span<float> out) const;
+    // loading-time variant: runs on own threads, not on Workers
+    void           landRayBatch      (std::span<const Tempest::Vec3> from, std::span<RayLandResult> out, float maxDy=0) const;
+
     NpcItem        ghostObj  (std::string_view visual);
     Item           staticObj (const PhysicMeshShape *src, const Tempest::Matrix4x4& m);
     Item           movableObj(const PhysicMeshShape *src, const Tempest::Matrix4x4& m);
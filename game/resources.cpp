@@ -19,7 +19,10 @@
 #include <phoenix/texture.hh>
 #include <phoenix/ext/dds_convert.hh>
 
+#include <atomic>
 #include <fstream>
+#include <future>
+#include <thread>
 
 #include "graphics/mesh/submesh/pfxemittermesh.h"
 #include "graphics/mesh/submesh/packedmesh.h"
@@ -776,6 +779,43 @@ const ProtoMesh* Resources::loadMesh(std::string_view name) {
   return inst->implLoadMesh(name);
   }
 
+void Resources::prefetchMeshes(const std::vector<std::string>& names) {
+  // NOTE: called from loading thread; file parsing and mesh packing are done without holding resource-lock
+  std::atomic_size_t next{0};
+  auto job = [&names,&next]() {
+    while(true) {
+      const size_t i = next.fetch_add(1);
+      if(i>=names.size())
+        break;
+      auto& name = names[i];
+      {
+      std::lock_guard<std::recursive_mutex> g(inst->sync);
+      if(inst->aniMeshCache.find(name)!=inst->aniMeshCache.end())
+        continue;
+      }
+      std::unique_ptr<ProtoMesh> t;
+      try {
+        t = inst->implLoadMeshMain(name);
+        }
+      catch(...) {
+        // error is reported by loadMesh later
+        }
+      if(t==nullptr)
+        continue;
+      std::lock_guard<std::recursive_mutex> g(inst->sync);
+      inst->aniMeshCache.emplace(name,std::move(t));
+      }
+    };
+
+  const size_t thCount = std::min<size_t>(std::max(1u,std::thread::hardware_concurrency()), (names.size()+15)/16);
+  std::vector<std::future<void>> th;
+  for(size_t i=1; i<thCount; ++i)
+    th.emplace_back(std::async(std::launch::async,job));
+  job();
+  for(auto& i:th)
+    i.wait();
+  }
+
 const PfxEmitterMesh* Resources::loadEmiterMesh(std::string_view name) {
   if(name.empty())
     return nullptr;
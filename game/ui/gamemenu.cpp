@@ -858,8 +858,11 @@ void GameMenu::execSingle(Item &it, int slideDx) {
 
   if(onEventAction[int(c_menu_item_select_event::execute)]>0){
     auto* sym = vm->find_symbol_by_index(uint32_t(onEventAction[int(c_menu_item_select_event::execute)]));
-    if (sym != nullptr)
-      vm->call_function(sym);
+    if(sym!=nullptr) {
+      if(auto w = Gothic::inst().world())
+        w->script().runMenuFunction(*vm,sym); else
+        vm->call_function(sym);
+      }
     }
 
   execChgOption(it,slideDx);
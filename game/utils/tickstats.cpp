@@ -0,0 +1,25 @@
+#include "tickstats.h"
+
+void TickStats::reset() {
+  for(auto& i:dt)
+    i = 0;
+  }
+
+void TickStats::add(Stage s, std::chrono::steady_clock::duration t) {
+  dt[s] += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+  }
+
+const char* TickStats::name(Stage s) {
+  switch(s) {
+    case S_NpcAi:     return "npc ai";
+    case S_Triggers:  return "triggers";
+    case S_Zones:     return "zones";
+    case S_Physics:   return "physics";
+    case S_Sound:     return "sound";
+    case S_View:      return "view";
+    case S_Effects:   return "effects";
+    case S_Animation: return "animation";
+    case S_Count:     break;
+    }
+  return "?";
+  }
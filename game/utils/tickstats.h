@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+class TickStats final {
+  public:
+    enum Stage : uint8_t {
+      S_NpcAi,
+      S_Triggers,
+      S_Zones,
+      S_Physics,
+      S_Sound,
+      S_View,
+      S_Effects,
+      S_Animation,
+      S_Count
+      };
+
+    class Scope final {
+      public:
+        Scope(TickStats& owner, Stage stage):owner(owner),stage(stage),time0(std::chrono::steady_clock::now()){}
+        Scope(const Scope&)=delete;
+        ~Scope() { owner.add(stage,std::chrono::steady_clock::now()-time0); }
+
+      private:
+        TickStats&                            owner;
+        Stage                                 stage;
+        std::chrono::steady_clock::time_point time0;
+      };
+
+    void               reset();
+    void               add(Stage s, std::chrono::steady_clock::duration dt);
+    uint64_t           time(Stage s) const { return dt[s]; }
+
+    static const char* name(Stage s);
+
+  private:
+    // nanoseconds, accumulated since last reset
+    uint64_t           dt[S_Count] = {};
+  };
@@ -94,6 +94,12 @@ bool CollisionZone::checkPos(const Tempest::Vec3& p) const {
   return false;
   }
 
+Tempest::Vec3 CollisionZone::extents() const {
+  if(type==T_Capsule)
+    return Tempest::Vec3(size.x,std::fabs(size.y),size.x);
+  return size;
+  }
+
 void CollisionZone::onIntersect(Npc& npc) {
   for(auto i:intersect)
     if(i==&npc)
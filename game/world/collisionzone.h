@@ -26,6 +26,7 @@ class CollisionZone final {
 
     Tempest::Vec3 position() const { return pos; }
     void          setPosition(const Tempest::Vec3& p);
+    Tempest::Vec3 extents() const;
 
     const std::vector<Npc*>& intersections() const { return intersect; }
 
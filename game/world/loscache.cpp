@@ -0,0 +1,68 @@
+#include "loscache.h"
+
+#include <cmath>
+
+bool LosCache::Key::operator ==(const Key& k) const {
+  if(npc!=k.npc)
+    return false;
+  for(int i=0; i<6; ++i)
+    if(v[i]!=k.v[i])
+      return false;
+  return true;
+  }
+
+size_t LosCache::KeyHash::operator()(const Key& k) const {
+  size_t h = std::hash<const Npc*>()(k.npc);
+  for(auto i:k.v)
+    h ^= std::hash<int32_t>()(i) + 0x9e3779b9 + (h<<6) + (h>>2);
+  return h;
+  }
+
+LosCache::Key LosCache::mkKey(const Npc& observer, const Tempest::Vec3& from, const Tempest::Vec3& to) {
+  Key k;
+  k.npc  = &observer;
+  k.v[0] = int32_t(std::floor(from.x/Quant));
+  k.v[1] = int32_t(std::floor(from.y/Quant));
+  k.v[2] = int32_t(std::floor(from.z/Quant));
+  k.v[3] = int32_t(std::floor(to.x/Quant));
+  k.v[4] = int32_t(std::floor(to.y/Quant));
+  k.v[5] = int32_t(std::floor(to.z/Quant));
+  return k;
+  }
+
+bool LosCache::find(const Key& k, bool& visible) {
+  auto& s = shard(k);
+  std::lock_guard<std::mutex> guard(s.sync);
+  auto it = s.data.find(k);
+  if(it==s.data.end()) {
+    misses.fetch_add(1,std::memory_order_relaxed);
+    return false;
+    }
+  hits.fetch_add(1,std::memory_order_relaxed);
+  visible = it->second;
+  return true;
+  }
+
+void LosCache::store(const Key& k, bool visible) {
+  auto& s = shard(k);
+  std::lock_guard<std::mutex> guard(s.sync);
+  s.data[k] = visible;
+  }
+
+void LosCache::clear() {
+  for(auto& s:shards) {
+    std::lock_guard<std::mutex> guard(s.sync);
+    s.data.clear();
+    }
+  }
+
+LosCache::Stats LosCache::stats() const {
+  Stats st;
+  st.hits   = hits.load(std::memory_order_relaxed);
+  st.misses = misses.load(std::memory_order_relaxed);
+  return st;
+  }
+
+LosCache::Shard& LosCache::shard(const Key& k) {
+  return shards[KeyHash()(k)%ShardsNum];
+  }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Tempest/Vec>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+class Npc;
+
+// line-of-sight results, valid for one world tick; safe to use from Workers
+class LosCache final {
+  public:
+    struct Stats {
+      uint64_t hits   = 0;
+      uint64_t misses = 0;
+      };
+
+    struct Key {
+      const Npc* npc = nullptr;
+      int32_t    v[6] = {};
+      bool operator == (const Key& k) const;
+      };
+
+    static Key mkKey(const Npc& observer, const Tempest::Vec3& from, const Tempest::Vec3& to);
+
+    bool  find (const Key& k, bool& visible);
+    void  store(const Key& k, bool  visible);
+    void  clear();
+    Stats stats() const;
+
+  private:
+    struct KeyHash {
+      size_t operator()(const Key& k) const;
+      };
+
+    struct Shard {
+      std::mutex                           sync;
+      std::unordered_map<Key,bool,KeyHash> data;
+      };
+
+    static constexpr float  Quant     = 4.f; // centimeters
+    static constexpr size_t ShardsNum = 16;
+
+    Shard&                 shard(const Key& k);
+
+    Shard                  shards[ShardsNum];
+    std::atomic<uint64_t>  hits{0};
+    std::atomic<uint64_t>  misses{0};
+  };
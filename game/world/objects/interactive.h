@@ -85,6 +85,7 @@ class Interactive : public Vob {
   protected:
     Tempest::Matrix4x4  nodeTranform(std::string_view nodeName) const;
     void                moveEvent() override;
+    bool                isPristine() const override { return false; }
     float               extendedSearchRadius() const override;
     virtual void        onStateChanged(){}
 
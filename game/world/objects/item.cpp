@@ -180,6 +180,11 @@ Tempest::Vec3 Item::position() const {
   return pos;
   }
 
+float Item::extendedSearchRadius() const {
+  auto b = view.bounds();
+  return (b.bbox[1]-b.bbox[0]).length()*0.5f;
+  }
+
 Vec3 Item::midPosition() const {
   auto b = view.bounds();
   return pos + (b.bbox[1]-b.bbox[0])*0.5;
@@ -180,6 +180,52 @@ Npc::~Npc(){
 
 void Npc::save(Serialize &fout, size_t id) {
   fout.setEntry("worlds/",fout.worldName(),"/npc/",id,"/data");
+  saveData(fout);
+
+  fout.setEntry("worlds/",fout.worldName(),"/npc/",id,"/visual");
+  visual.save(fout,*this);
+
+  fout.setEntry("worlds/",fout.worldName(),"/npc/",id,"/inventory");
+  if(!invent.isEmpty() || id==size_t(-1))
+    invent.save(fout);
+  }
+
+void Npc::load(Serialize &fin, size_t id) {
+  fin.setEntry("worlds/",fin.worldName(),"/npc/",id,"/data");
+  Vec3 phyPos       = {};
+  bool isUsingTorch = false;
+  loadData(fin,phyPos,isUsingTorch);
+
+  fin.setEntry("worlds/",fin.worldName(),"/npc/",id,"/visual");
+  loadVisual(fin,phyPos);
+
+  if(fin.setEntry("worlds/",fin.worldName(),"/npc/",id,"/inventory"))
+    invent.load(fin,*this);
+  postLoad(isUsingTorch);
+  }
+
+void Npc::saveRecord(Serialize& fout) {
+  saveData(fout);
+  visual.save(fout,*this);
+  const bool hasInv = !invent.isEmpty();
+  fout.write(hasInv);
+  if(hasInv)
+    invent.save(fout);
+  }
+
+void Npc::loadRecord(Serialize& fin) {
+  Vec3 phyPos       = {};
+  bool isUsingTorch = false;
+  bool hasInv       = false;
+  loadData(fin,phyPos,isUsingTorch);
+  loadVisual(fin,phyPos);
+  fin.read(hasInv);
+  if(hasInv)
+    invent.load(fin,*this);
+  postLoad(isUsingTorch);
+  }
+
+void Npc::saveData(Serialize& fout) {
   fout.write(*hnpc);
   fout.write(body,head,vHead,vTeeth,bdColor,vColor,bdFatness);
   fout.write(x,y,z,angle,sz);
@@ -215,18 +261,9 @@ void Npc::save(Serialize &fout, size_t id) {
 
   Vec3 phyPos = physic.position();
   fout.write(phyPos);
-
-  fout.setEntry("worlds/",fout.worldName(),"/npc/",id,"/visual");
-  visual.save(fout,*this);
-
-  fout.setEntry("worlds/",fout.worldName(),"/npc/",id,"/inventory");
-  if(!invent.isEmpty() || id==size_t(-1))
-    invent.save(fout);
   }
 
-void Npc::load(Serialize &fin, size_t id) {
-  fin.setEntry("worlds/",fin.worldName(),"/npc/",id,"/data");
-
+void Npc::loadData(Serialize& fin, Vec3& phyPos, bool& isUsingTorch) {
   hnpc = std::make_shared<phoenix::c_npc>();
   hnpc->user_ptr        = this;
   fin.readNpc(owner.script().getVm(), hnpc);
@@ -272,24 +309,22 @@ void Npc::load(Serialize &fin, size_t id) {
   fghAlgo.load(fin);
   fin.read(lastEventTime,angleY,runAng);
 
-  bool isUsingTorch = false;
   if(fin.version()>36) {
     fin.read(invTorch);
     fin.read(isUsingTorch);
     }
 
-  Vec3 phyPos = {};
   fin.read(phyPos);
+  }
 
-  fin.setEntry("worlds/",fin.worldName(),"/npc/",id,"/visual");
+void Npc::loadVisual(Serialize& fin, const Vec3& phyPos) {
   visual.load(fin,*this);
   physic.setPosition(phyPos);
 
   setVisualBody(vHead,vTeeth,vColor,bdColor,body,head);
+  }
 
-  if(fin.setEntry("worlds/",fin.worldName(),"/npc/",id,"/inventory"))
-    invent.load(fin,*this);
-
+void Npc::postLoad(bool isUsingTorch) {
   // post-alignment
   updateTransform();
   if(isUsingTorch)
@@ -2797,7 +2832,9 @@ void Npc::commitSpell() {
     invent.updateView(*this);
     visual.clearOverlays();
 
+    const uint32_t prevSym = instanceSymbol();
     owner.script().initializeInstanceNpc(hnpc, size_t(spellInfo));
+    owner.updateNpcInstance(*this,prevSym);
     spellInfo  = 0;
     hnpc->level = transformSpl->hnpc->level;
     }
@@ -3712,6 +3749,14 @@ void Npc::startDialog(Npc& pl) {
   }
 
 bool Npc::perceptionProcess(Npc &pl) {
+  return perceptionProcess(pl,canAssessPlayer(pl));
+  }
+
+bool Npc::canAssessPlayer(const Npc& pl) const {
+  return hasPerc(PERC_ASSESSPLAYER) && (canSenseNpc(pl,false) & SensesBit::SENSE_SEE)==SensesBit::SENSE_SEE;
+  }
+
+bool Npc::perceptionProcess(Npc &pl, bool seePlayer) {
   static bool disable=false;
   if(disable)
     return false;
@@ -3726,7 +3771,7 @@ bool Npc::perceptionProcess(Npc &pl) {
     }
 
   const float quadDist = pl.qDistTo(*this);
-  if(hasPerc(PERC_ASSESSPLAYER) && (canSenseNpc(pl,false) & SensesBit::SENSE_SEE)==SensesBit::SENSE_SEE) {
+  if(seePlayer) {
     if(perceptionProcess(pl,nullptr,quadDist,PERC_ASSESSPLAYER)) {
       ret = true;
       }
@@ -3834,6 +3879,17 @@ Interactive* Npc::detectedMob() const {
   return nullptr;
   }
 
+uint32_t Npc::currentSector() const {
+  // bsp-lookup is not free and perception asks for it every tick, for every pair of npc's
+  auto pos = position();
+  if(!sectorCacheOk || sectorCacheKey.x!=pos.x || sectorCacheKey.y!=pos.y || sectorCacheKey.z!=pos.z) {
+    sectorCacheKey = pos;
+    sectorCache    = owner.sectorAt(pos);
+    sectorCacheOk  = true;
+    }
+  return sectorCache;
+  }
+
 bool Npc::isState(ScriptFn stateFn) const {
   return aiState.funcIni==stateFn;
   }
@@ -4013,7 +4069,9 @@ void Npc::startDive() {
 void Npc::transformBack() {
   if(transformSpl==nullptr)
     return;
+  const uint32_t prevSym = instanceSymbol();
   transformSpl->undo(*this);
+  owner.updateNpcInstance(*this,prevSym);
   setVisual(transformSpl->skeleton);
   setVisualBody(vHead,vTeeth,vColor,bdColor,body,head);
   closeWeapon(true);
@@ -4116,7 +4174,6 @@ SensesBit Npc::canSenseNpc(const Npc &oth, bool freeLos, float extRange) const {
   }
 
 SensesBit Npc::canSenseNpc(float tx, float ty, float tz, bool freeLos, bool isNoisy, float extRange) const {
-  DynamicWorld* w = owner.physic();
   static const double ref = std::cos(100*M_PI/180.0); // spec requires +-100 view angle range
 
   const float range = float(hnpc->senses_range)+extRange;
@@ -4124,7 +4181,7 @@ SensesBit Npc::canSenseNpc(float tx, float ty, float tz, bool freeLos, bool isNo
     return SensesBit::SENSE_NONE;
 
   SensesBit ret=SensesBit::SENSE_NONE;
-  if(owner.roomAt({tx,ty,tz})==owner.roomAt({x,y,z})) {
+  if(owner.sectorAt({tx,ty,tz})==currentSector()) {
     ret = ret | SensesBit::SENSE_SMELL;
     }
 
@@ -4140,10 +4197,10 @@ SensesBit Npc::canSenseNpc(float tx, float ty, float tz, bool freeLos, bool isNo
     float dir = angleDir(dx,dz);
     float da  = float(M_PI)*(visual.viewDirection()-dir)/180.f;
     if(double(std::cos(da))<=ref)
-      if(!w->ray(head, Vec3(tx,ty,tz)).hasCol)
+      if(owner.hasLineOfSight(*this, head, Vec3(tx,ty,tz)))
         ret = ret | SensesBit::SENSE_SEE;
     } else {
-    if(!w->ray(head, Vec3(tx,ty,tz)).hasCol)
+    if(owner.hasLineOfSight(*this, head, Vec3(tx,ty,tz)))
       ret = ret | SensesBit::SENSE_SEE;
     }
   return ret & SensesBit(hnpc->senses);
@@ -4231,7 +4288,7 @@ void Npc::updateTransform() {
   updateAnimation(0);
   }
 
-void Npc::updateAnimation(uint64_t dt) {
+void Npc::updateAnimation(uint64_t dt, bool sample) {
   const auto camera = Gothic::inst().camera();
   if(isPlayer() && camera!=nullptr && camera->isFree())
     dt = 0;
@@ -4264,7 +4321,7 @@ void Npc::updateAnimation(uint64_t dt) {
     durtyTranform = 0;
     }
 
-  bool syncAtt = visual.updateAnimation(this,owner,dt);
+  bool syncAtt = visual.updateAnimation(this,owner,dt,sample);
   if(syncAtt)
     visual.syncAttaches();
   }
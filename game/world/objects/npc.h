@@ -81,6 +81,9 @@ class Npc final {
 
     void       save(Serialize& fout, size_t id);
     void       load(Serialize& fout, size_t id);
+    // single record, within current entry
+    void       saveRecord(Serialize& fout);
+    void       loadRecord(Serialize& fin);
     void       postValidate();
 
     bool       setPosition (float x,float y,float z);
@@ -130,7 +133,9 @@ class Npc final {
     float      qDistTo(const Interactive& p) const;
     float      qDistTo(const Item& p) const;
 
-    void       updateAnimation(uint64_t dt);
+    void       updateAnimation(uint64_t dt, bool sample = true);
+    AnimLod    animLod() const { return animLodTier; }
+    void       setAnimLod(AnimLod lod) { animLodTier = lod; }
     void       updateTransform();
 
     std::string_view displayName() const;
@@ -285,6 +290,8 @@ class Npc final {
     void      setPerceptionDisable(PercType t);
 
     bool      perceptionProcess(Npc& pl);
+    bool      perceptionProcess(Npc& pl, bool seePlayer);
+    bool      canAssessPlayer(const Npc& pl) const;
     bool      perceptionProcess(Npc& pl, Npc *victum, float quadDist, PercType perc);
     bool      hasPerc(PercType perc) const;
     uint64_t  percNextTime() const;
@@ -295,6 +302,7 @@ class Npc final {
     void      processDefInvTorch();
 
     auto      detectedMob() const -> Interactive*;
+    uint32_t  currentSector() const;
     void      setDetectedMob(Interactive* id);
 
     bool      isState   (ScriptFn stateFn) const;
@@ -497,6 +505,10 @@ class Npc final {
 
     void      dropTorch(bool burnout = false);
 
+    void      saveData(Serialize& fout);
+    void      loadData(Serialize& fin, Tempest::Vec3& phyPos, bool& isUsingTorch);
+    void      loadVisual(Serialize& fin, const Tempest::Vec3& phyPos);
+    void      postLoad(bool isUsingTorch);
     void      saveAiState(Serialize& fout) const;
     void      loadAiState(Serialize& fin);
     void      saveTrState(Serialize& fout) const;
@@ -595,6 +607,10 @@ class Npc final {
     Tempest::Vec3                  moveMobCacheKey={};
     Interactive*                   moveMob        =nullptr;
 
+    mutable Tempest::Vec3          sectorCacheKey ={};
+    mutable uint32_t               sectorCache    =uint32_t(-1);
+    mutable bool                   sectorCacheOk  =false;
+
     GoTo                           go2;
     const WayPoint*                currentFp      =nullptr;
     FpLock                         currentFpLock;
@@ -603,6 +619,7 @@ class Npc final {
     MoveAlgo                       mvAlgo;
     FightAlgo                      fghAlgo;
     uint64_t                       lastEventTime=0;
+    AnimLod                        animLodTier  =ANIM_Full;
 
     float                          angleY   = 0.f;
     float                          runAng   = 0.f;
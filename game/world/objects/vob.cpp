@@ -64,6 +64,7 @@ Vec3 Vob::position() const {
 void Vob::setGlobalTransform(const Matrix4x4& p) {
   pos   = p;
   local = pos;
+  moved = true;
 
   if(parent!=nullptr) {
     auto m = parent->transform();
@@ -88,6 +89,10 @@ bool Vob::setMobState(std::string_view scheme, int32_t st) {
 void Vob::moveEvent() {
   }
 
+bool Vob::isPristine() const {
+  return !moved;
+  }
+
 bool Vob::isDynamic() const {
   return false;
   }
@@ -97,13 +102,21 @@ float Vob::extendedSearchRadius() const {
   }
 
 void Vob::recalculateTransform() {
-  auto old = position();
+  const auto prev = pos;
+  const auto old  = position();
   if(parent!=nullptr) {
     pos = parent->transform();
     pos.mul(local);
     } else {
     pos = local;
     }
+  // rotation-only change must be saved as well
+  for(int i=0; i<4 && !moved; ++i)
+    for(int r=0; r<4; ++r)
+      if(prev.at(i,r)!=pos.at(i,r)) {
+        moved = true;
+        break;
+        }
   if(old!=position() && !isDynamic()) {
     switch(vobType) {
       case phoenix::vob_type::oCMOB:
@@ -243,7 +256,7 @@ void Vob::saveVobTree(Serialize& fin) const {
     i->saveVobTree(fin);
   if(vobType==phoenix::vob_type::zCVob)
     return;
-  if(vobObjectID!=uint32_t(-1))
+  if(vobObjectID!=uint32_t(-1) && !isPristine())
     save(fin);
   }
 
@@ -276,5 +289,6 @@ void Vob::load(Serialize& fin) {
     if(savValue!=type)
       throw std::logic_error("inconsistent *.sav vs world");
     }
+  moved = true;
   moveEvent();
   }
@@ -47,12 +47,15 @@ class Vob {
     uint32_t                          vobObjectID = uint32_t(-1);
 
     virtual void  moveEvent();
+    // no runtime state beyond zen-data: such vob is skipped in save-game
+    virtual bool  isPristine() const;
 
   private:
     std::vector<std::unique_ptr<Vob>> child;
 
     Tempest::Matrix4x4                pos, local;
     Vob*                              parent = nullptr;
+    bool                              moved  = false;
 
     void          recalculateTransform();
   };
@@ -6,69 +6,114 @@ void BaseSpaceIndex::clear() {
   arr.clear();
   index.clear();
   dynamic.clear();
+  slot.clear();
+  built   = false;
+  changes = 0;
   }
 
 void BaseSpaceIndex::invalidate() {
-  index.clear();
-  dynamic.clear();
+  built = false;
   }
 
 void BaseSpaceIndex::add(Vob* v) {
+  Slot s;
+  s.arr = arr.size();
   arr.push_back(v);
-  index.reserve(arr.size());
-  index.clear();
-  dynamic.clear();
+  if(built) {
+    // no rebuild: keep in linear list, until enough changes are accumulated
+    s.extra = dynamic.size();
+    dynamic.push_back(v);
+    onChange();
+    }
+  slot[v] = s;
   }
 
 void BaseSpaceIndex::del(Vob* v) {
-  for(size_t i=0;i<arr.size();++i) {
-    if(arr[i]==v) {
-      arr[i] = arr.back();
-      arr.pop_back();
-      index.clear();
-      dynamic.clear();
-      return;
+  auto it = slot.find(v);
+  if(it==slot.end())
+    return;
+  const Slot s = it->second;
+
+  arr[s.arr] = arr.back();
+  slot[arr[s.arr]].arr = s.arr;
+  arr.pop_back();
+
+  if(built) {
+    if(s.node!=size_t(-1))
+      index[s.node].obj = nullptr;
+    if(s.extra!=size_t(-1)) {
+      dynamic[s.extra] = dynamic.back();
+      slot[dynamic[s.extra]].extra = s.extra;
+      dynamic.pop_back();
       }
+    onChange();
     }
+  slot.erase(v);
   }
 
 bool BaseSpaceIndex::hasObject(const Vob* v) const {
   if(v==nullptr)
     return false;
-  for(size_t i=0;i<arr.size();++i)
-    if(arr[i]==v)
-      return true;
-  return false;
+  return slot.find(v)!=slot.end();
+  }
+
+void BaseSpaceIndex::onChange() {
+  changes++;
+  if(changes>std::max<size_t>(32,index.size()/4))
+    built = false;
   }
 
 void BaseSpaceIndex::find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(index.size()==0)
+  if(!built)
     buildIndex();
   for(auto& i:dynamic)
     (*func)(ctx,i);
-  implFind(index.data(),index.size(),0,p,R,ctx,func);
+  implFind(index.data(),index.size(),p,R,ctx,func);
   }
 
 void BaseSpaceIndex::buildIndex() {
-  size_t cnt = 0;
-  index.resize(arr.size());
+  index.clear();
   dynamic.clear();
+  index.reserve(arr.size());
   for(size_t i=0; i<arr.size(); ++i) {
+    auto& s = slot[arr[i]];
+    s.node  = size_t(-1);
+    s.extra = size_t(-1);
     if(arr[i]->isDynamic()) {
+      s.extra = dynamic.size();
       dynamic.push_back(arr[i]);
       } else {
-      index[cnt] = arr[i];
-      ++cnt;
+      Node n;
+      n.pos    = arr[i]->position();
+      n.radius = arr[i]->extendedSearchRadius() + Padding;
+      n.obj    = arr[i];
+      index.push_back(n);
       }
     }
-  index.resize(cnt);
   buildIndex(index.data(),index.size(),0);
+  for(size_t i=0; i<index.size(); ++i)
+    slot[index[i].obj].node = i;
+  built   = true;
+  changes = 0;
   }
 
-void BaseSpaceIndex::buildIndex(Vob** v, size_t cnt, uint8_t depth) {
+void BaseSpaceIndex::buildIndex(Node* v, size_t cnt, uint8_t depth) {
   depth%=3;
-  sort(v,cnt,depth);
   size_t mid = cnt/2;
+  if(cnt==0)
+    return;
+  if(cnt==1) {
+    updateBounds(v,cnt);
+    return;
+    }
+  // median split is enough for k-d tree; no need for full sort
+  std::nth_element(v,v+mid,v+cnt,[depth](const Node& a, const Node& b){
+    switch(depth) {
+      case 0:  return a.pos.x < b.pos.x;
+      case 1:  return a.pos.y < b.pos.y;
+      default: return a.pos.z < b.pos.z;
+      }
+    });
   if(mid>0) {
     // [0..mid)
     buildIndex(v,mid,uint8_t(depth+1u));
@@ -77,56 +122,50 @@ void BaseSpaceIndex::buildIndex(Vob** v, size_t cnt, uint8_t depth) {
     // (mid..cnt)
     buildIndex(v+mid+1,cnt-mid-1,uint8_t(depth+1u));
     }
+  updateBounds(v,cnt);
   }
 
-void BaseSpaceIndex::sort(Vob** v, size_t cnt, uint8_t component) {
-  bool (*predicate)(const Vob* a, const Vob* b) = nullptr;
-  switch(component) {
-    case 0:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().x < b->position().x; };
-      break;
-    case 1:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().y < b->position().y; };
-      break;
-    case 2:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().z < b->position().z; };
-      break;
-    }
-  std::sort(v,v+cnt,predicate);
+void BaseSpaceIndex::updateBounds(Node* v, size_t cnt) {
+  const size_t mid = cnt/2;
+  auto&        n   = v[mid];
+  const Tempest::Vec3 r = {n.radius,n.radius,n.radius};
+  n.bbox[0] = n.pos - r;
+  n.bbox[1] = n.pos + r;
+
+  auto merge = [&n](const Node& c) {
+    n.bbox[0].x = std::min(n.bbox[0].x,c.bbox[0].x);
+    n.bbox[0].y = std::min(n.bbox[0].y,c.bbox[0].y);
+    n.bbox[0].z = std::min(n.bbox[0].z,c.bbox[0].z);
+    n.bbox[1].x = std::max(n.bbox[1].x,c.bbox[1].x);
+    n.bbox[1].y = std::max(n.bbox[1].y,c.bbox[1].y);
+    n.bbox[1].z = std::max(n.bbox[1].z,c.bbox[1].z);
+    };
+  if(mid>0)
+    merge(v[mid/2]);
+  if(mid+1<cnt)
+    merge(v[mid+1+(cnt-mid-1)/2]);
   }
 
-void BaseSpaceIndex::implFind(Vob** v, size_t cnt, uint8_t depth,
+void BaseSpaceIndex::implFind(const Node* v, size_t cnt,
                               const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
   if(cnt==0)
     return;
 
-  auto mid = cnt/2;
-  auto pos = v[mid]->position();
-  auto qR  = (R+675.0);//v[mid]->extendedSearchRadius());
+  auto  mid = cnt/2;
+  auto& n   = v[mid];
 
-  if((pos-p).quadLength()<=qR*qR) {
-    func(ctx,v[mid]);
-    }
+  // sphere vs bounds of sub-tree
+  float dx = std::max({0.f, n.bbox[0].x-p.x, p.x-n.bbox[1].x});
+  float dy = std::max({0.f, n.bbox[0].y-p.y, p.y-n.bbox[1].y});
+  float dz = std::max({0.f, n.bbox[0].z-p.z, p.z-n.bbox[1].z});
+  if(dx*dx+dy*dy+dz*dz > R*R)
+    return;
 
-  depth%=3;
-  switch(depth) {
-    case 0:
-      if(p.x-qR<=pos.x)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.x+qR>=pos.x)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 1:
-      if(p.y-qR<=pos.y)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.y+qR>=pos.y)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 2:
-      if(p.z-qR<=pos.z)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.z+qR>=pos.z)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
+  const float qR = R+n.radius;
+  if(n.obj!=nullptr && (n.obj->position()-p).quadLength()<=qR*qR) {
+    func(ctx,n.obj);
     }
+
+  implFind(v,mid,p,R,ctx,func);
+  implFind(v+mid+1,cnt-mid-1,p,R,ctx,func);
   }
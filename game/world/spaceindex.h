@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <memory>
+#include <unordered_map>
 #include <Tempest/Point>
 
 #include "utils/workers.h"
@@ -30,14 +31,35 @@ class BaseSpaceIndex {
     Vob*const*         data() const { return arr.data(); }
 
   private:
+    struct Node {
+      Tempest::Vec3    pos;           // position at build time
+      float            radius = 0;
+      Tempest::Vec3    bbox[2];       // bounds of the sub-tree, including radius
+      Vob*             obj = nullptr; // nullptr, if object was removed after build
+      };
+
+    struct Slot {
+      size_t           arr   = 0;
+      size_t           node  = size_t(-1);
+      size_t           extra = size_t(-1);
+      };
+
     std::vector<Vob*>  arr;
-    std::vector<Vob*>  index;
-    std::vector<Vob*>  dynamic;
+    std::vector<Node>  index;
+    std::vector<Vob*>  dynamic; // dynamic objects and objects added after build
+    std::unordered_map<const Vob*,Slot> slot;
+
+    bool               built   = false;
+    size_t             changes = 0;
+
+    // callers measure distance from npc pelvis or item center, not from vob origin
+    static constexpr float Padding = 150.f;
 
     void               buildIndex();
-    void               buildIndex(Vob** v, size_t cnt, uint8_t depth);
-    void               sort(Vob** v, size_t cnt, uint8_t component);
-    void               implFind(Vob** v, size_t cnt, uint8_t depth, const Tempest::Vec3& p, float R, const void* ctx, void(*func)(const void*, Vob*));
+    void               buildIndex(Node* v, size_t cnt, uint8_t depth);
+    void               onChange();
+    void               updateBounds(Node* v, size_t cnt);
+    void               implFind(const Node* v, size_t cnt, const Tempest::Vec3& p, float R, const void* ctx, void(*func)(const void*, Vob*));
   };
 
 template<class Func>
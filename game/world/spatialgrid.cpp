@@ -0,0 +1,44 @@
+#include "spatialgrid.h"
+
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize)
+  :cellSize(cellSize) {
+  }
+
+void SpatialGrid::clear() {
+  cells.clear();
+  large.clear();
+  }
+
+void SpatialGrid::insert(uint32_t id, const Tempest::Vec3& pos) {
+  cells.push_back({key(cellOf(pos.x),cellOf(pos.z)),id});
+  }
+
+void SpatialGrid::insert(uint32_t id, const Tempest::Vec3& pos, const Tempest::Vec3& halfSize) {
+  const float   hx = std::fabs(halfSize.x), hz = std::fabs(halfSize.z);
+  const int32_t x0 = cellOf(pos.x-hx), x1 = cellOf(pos.x+hx);
+  const int32_t z0 = cellOf(pos.z-hz), z1 = cellOf(pos.z+hz);
+  if(int64_t(x1)-x0>=MaxSpan || int64_t(z1)-z0>=MaxSpan) {
+    large.push_back(id);
+    return;
+    }
+  for(int32_t x=x0; x<=x1; ++x)
+    for(int32_t z=z0; z<=z1; ++z)
+      cells.push_back({key(x,z),id});
+  }
+
+void SpatialGrid::build() {
+  std::sort(cells.begin(),cells.end(),[](const Cell& a, const Cell& b){
+    return a.key<b.key || (a.key==b.key && a.id<b.id);
+    });
+  }
+
+int32_t SpatialGrid::cellOf(float v) const {
+  const float c = std::floor(v/cellSize);
+  if(!(c>-2.e9f))
+    return -2000000000;
+  if(!(c<2.e9f))
+    return 2000000000;
+  return int32_t(c);
+  }
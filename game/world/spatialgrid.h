@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Tempest/Vec>
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+
+// uniform grid on xz-plane, rebuilt every tick for short-living objects (perceptions, collision zones)
+class SpatialGrid final {
+  public:
+    explicit SpatialGrid(float cellSize);
+
+    void   clear();
+    void   insert(uint32_t id, const Tempest::Vec3& pos);
+    void   insert(uint32_t id, const Tempest::Vec3& pos, const Tempest::Vec3& halfSize);
+    void   build();
+    bool   isEmpty() const { return cells.empty() && large.empty(); }
+
+    // calls f(id) for every object, that may overlap with xz-square; order is unspecified
+    // NOTE: object, inserted with halfSize, can be reported more than once
+    template<class F>
+    void   query(const Tempest::Vec3& pos, float radius, const F& f) const {
+      const int32_t x0 = cellOf(pos.x-radius), x1 = cellOf(pos.x+radius);
+      const int32_t z0 = cellOf(pos.z-radius), z1 = cellOf(pos.z+radius);
+      if(int64_t(x1)-x0>=MaxSpan || int64_t(z1)-z0>=MaxSpan) {
+        for(auto& i:cells)
+          f(i.id);
+        } else {
+        queryCells(x0,x1,z0,z1,f);
+        }
+      for(auto i:large)
+        f(i);
+      }
+
+  private:
+    struct Cell {
+      uint64_t key = 0;
+      uint32_t id  = 0;
+      };
+
+    // objects spanning more cells are stored in 'large' and reported by every query
+    static constexpr int32_t MaxSpan = 8;
+
+    template<class F>
+    void   queryCells(int32_t x0, int32_t x1, int32_t z0, int32_t z1, const F& f) const {
+      for(int32_t x=x0; x<=x1; ++x)
+        for(int32_t z=z0; z<=z1; ++z) {
+          auto r = std::equal_range(cells.begin(),cells.end(),Cell{key(x,z),0},[](const Cell& a, const Cell& b){
+            return a.key<b.key;
+            });
+          for(auto i=r.first; i!=r.second; ++i)
+            f(i->id);
+          }
+      }
+
+    int32_t         cellOf(float v) const;
+    static uint64_t key(int32_t x, int32_t z) { return (uint64_t(uint32_t(x))<<32) | uint32_t(z); }
+
+    float                 cellSize = 0;
+    std::vector<Cell>     cells;
+    std::vector<uint32_t> large;
+  };
@@ -42,7 +42,9 @@ AbstractTrigger::AbstractTrigger(Vob* parent, World &world, const phoenix::vob&
   world.addTrigger(this);
   }
 
-AbstractTrigger::~AbstractTrigger() {}
+AbstractTrigger::~AbstractTrigger() {
+  world.removeTrigger(this);
+  }
 
 std::string_view AbstractTrigger::name() const {
   return vobName;
@@ -82,6 +82,7 @@ class AbstractTrigger : public Vob {
     virtual void                 onUntrigger(const TriggerEvent& evt);
     virtual void                 onGotoMsg(const TriggerEvent& evt);
     void                         moveEvent() override;
+    bool                         isPristine() const override { return false; }
 
     bool                         hasFlag(ReactFlg flg) const;
 
@@ -0,0 +1,165 @@
+#include "waygrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "waypoint.h"
+
+using namespace Tempest;
+
+void WayGrid::clear() {
+  cells.clear();
+  points.clear();
+  dim[0] = dim[1] = dim[2] = 0;
+  }
+
+void WayGrid::build(const std::vector<const WayPoint*>& pt) {
+  clear();
+  if(pt.empty())
+    return;
+
+  Vec3 bmin = pt[0]->position(), bmax = bmin;
+  for(auto i:pt) {
+    auto p = i->position();
+    bmin.x = std::min(bmin.x,p.x);
+    bmin.y = std::min(bmin.y,p.y);
+    bmin.z = std::min(bmin.z,p.z);
+    bmax.x = std::max(bmax.x,p.x);
+    bmax.y = std::max(bmax.y,p.y);
+    bmax.z = std::max(bmax.z,p.z);
+    }
+
+  // grow cells, if world is too large (or has stray points far away)
+  cellSize = DefaultCellSize;
+  while(true) {
+    dim[0] = int32_t((bmax.x-bmin.x)/cellSize)+1;
+    dim[1] = int32_t((bmax.y-bmin.y)/cellSize)+1;
+    dim[2] = int32_t((bmax.z-bmin.z)/cellSize)+1;
+    if(uint64_t(dim[0])*uint64_t(dim[1])*uint64_t(dim[2])<=MaxCells)
+      break;
+    cellSize *= 2.f;
+    }
+  origin = bmin;
+
+  const size_t count = size_t(dim[0])*size_t(dim[1])*size_t(dim[2]);
+  cells.assign(count+1,0);
+
+  int32_t c[3] = {};
+  for(auto i:pt) {
+    cellAt(i->position(),c);
+    cells[cellId(c)+1]++;
+    }
+  for(size_t i=1; i<cells.size(); ++i)
+    cells[i] += cells[i-1];
+
+  std::vector<uint32_t> fill(cells.begin(),cells.end()-1);
+  points.resize(pt.size());
+  for(auto i:pt) {
+    cellAt(i->position(),c);
+    points[fill[cellId(c)]++] = i;
+    }
+  }
+
+const WayPoint* WayGrid::findNearest(const Vec3& at, float R, const Filter& filter) const {
+  const WayPoint* ret = nullptr;
+  visit(at,R,[&](const WayPoint& w) {
+    if(!filter(w))
+      return false;
+    ret = &w;
+    return true;
+    });
+  return ret;
+  }
+
+size_t WayGrid::findKNearest(const Vec3& at, float R, size_t k, std::vector<const WayPoint*>& out, const Filter& filter) const {
+  out.clear();
+  if(k==0)
+    return 0;
+  visit(at,R,[&](const WayPoint& w) {
+    if(filter(w))
+      out.push_back(&w);
+    return out.size()>=k;
+    });
+  return out.size();
+  }
+
+void WayGrid::cellAt(const Vec3& p, int32_t c[3]) const {
+  // not clamped: query point can be outside of the grid
+  c[0] = int32_t(std::floor((p.x-origin.x)/cellSize));
+  c[1] = int32_t(std::floor((p.y-origin.y)/cellSize));
+  c[2] = int32_t(std::floor((p.z-origin.z)/cellSize));
+  }
+
+size_t WayGrid::cellId(const int32_t c[3]) const {
+  return (size_t(c[2])*size_t(dim[1]) + size_t(c[1]))*size_t(dim[0]) + size_t(c[0]);
+  }
+
+void WayGrid::collect(const Vec3& at, float R2, const int32_t c[3], std::vector<Cand>& out) const {
+  const size_t id = cellId(c);
+  for(uint32_t i=cells[id]; i<cells[id+1]; ++i) {
+    auto  wp = points[i];
+    float l  = (wp->position()-at).quadLength();
+    if(l<=R2)
+      out.push_back({l,wp});
+    }
+  }
+
+template<class Fn>
+void WayGrid::visit(const Vec3& at, float R, Fn fn) const {
+  if(points.empty())
+    return;
+
+  int32_t c[3] = {};
+  cellAt(at,c);
+
+  // last shell, that still intersects the grid
+  int32_t rMax = 0;
+  for(int i=0; i<3; ++i)
+    rMax = std::max(rMax,std::max(std::abs(c[i]),std::abs(dim[i]-1-c[i])));
+  if(R<float(rMax)*cellSize)
+    rMax = int32_t(R/cellSize)+1;
+
+  const float       R2 = R*R;
+  std::vector<Cand> pending;
+  size_t            head = 0;
+
+  auto lo = [&](int i, int32_t r) { return std::max(c[i]-r,0);        };
+  auto hi = [&](int i, int32_t r) { return std::min(c[i]+r,dim[i]-1); };
+
+  for(int32_t r=0; r<=rMax; ++r) {
+    // cells with chebyshev distance == r
+    int32_t cell[3] = {};
+    for(cell[0]=lo(0,r); cell[0]<=hi(0,r); ++cell[0]) {
+      const bool ex = std::abs(cell[0]-c[0])==r;
+      for(cell[1]=lo(1,r); cell[1]<=hi(1,r); ++cell[1]) {
+        const bool ey = std::abs(cell[1]-c[1])==r;
+        if(ex || ey) {
+          for(cell[2]=lo(2,r); cell[2]<=hi(2,r); ++cell[2])
+            collect(at,R2,cell,pending);
+          continue;
+          }
+        cell[2] = c[2]-r;
+        if(0<=cell[2] && cell[2]<dim[2])
+          collect(at,R2,cell,pending);
+        cell[2] = c[2]+r;
+        if(r>0 && 0<=cell[2] && cell[2]<dim[2])
+          collect(at,R2,cell,pending);
+        }
+      }
+
+    std::sort(pending.begin()+int(head),pending.end(),[](const Cand& a, const Cand& b){
+      return a.dist<b.dist;
+      });
+    // everything in unvisited shells is further than r*cellSize
+    const float safe = float(r)*cellSize;
+    while(head<pending.size() && pending[head].dist<=safe*safe) {
+      if(fn(*pending[head].wp))
+        return;
+      ++head;
+      }
+    }
+
+  for(; head<pending.size(); ++head)
+    if(fn(*pending[head].wp))
+      return;
+  }
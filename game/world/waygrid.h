@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Tempest/Vec>
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+class WayPoint;
+
+// uniform 3d grid over static set of waypoints
+class WayGrid final {
+  public:
+    using Filter = std::function<bool(const WayPoint&)>;
+
+    void            build(const std::vector<const WayPoint*>& pt);
+    void            clear();
+    size_t          size() const { return points.size(); }
+
+    // nearest point in radius R, that passes filter; filter is called in order of increasing distance
+    const WayPoint* findNearest (const Tempest::Vec3& at, float R, const Filter& filter) const;
+    size_t          findKNearest(const Tempest::Vec3& at, float R, size_t k, std::vector<const WayPoint*>& out, const Filter& filter) const;
+
+  private:
+    struct Cand {
+      float           dist = 0;
+      const WayPoint* wp   = nullptr;
+      };
+
+    static constexpr float  DefaultCellSize = 5.f*100.f;
+    static constexpr size_t MaxCells        = 1u<<20;
+
+    float                        cellSize = DefaultCellSize;
+    Tempest::Vec3                origin;
+    int32_t                      dim[3] = {};
+    std::vector<uint32_t>        cells; // prefix sum: points of cell[i] are [cells[i], cells[i+1])
+    std::vector<const WayPoint*> points;
+
+    void            cellAt(const Tempest::Vec3& p, int32_t c[3]) const;
+    size_t          cellId(const int32_t c[3]) const;
+    void            collect(const Tempest::Vec3& at, float R2, const int32_t c[3], std::vector<Cand>& out) const;
+
+    template<class Fn>
+    void            visit(const Tempest::Vec3& at, float R, Fn fn) const;
+  };
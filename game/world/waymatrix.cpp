@@ -26,8 +26,6 @@ WayMatrix::WayMatrix(World &world, const phoenix::way_net &dat)
     }
 
   edges = dat.edges;
-  stk[0].reserve(256);
-  stk[1].reserve(256);
   }
 
 void WayMatrix::buildIndex() {
@@ -39,12 +37,14 @@ void WayMatrix::buildIndex() {
     return a->name<b->name;
     });
 
-  for(auto& i:freePoints)
-    fpInd.push_back(&i);
+  std::vector<const WayPoint*> pt;
+  pt.reserve(wayPoints.size());
+  for(auto& i:wayPoints)
+    pt.push_back(&i);
+  wayGrid.build(pt);
 
-  std::sort(fpInd.begin(),fpInd.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->x<b->x;
-    });
+  pt.assign(indexPoints.begin(),indexPoints.end());
+  indexGrid.build(pt);
 
   for(auto& i:edges) {
     if(i.a<wayPoints.size() && i.b<wayPoints.size()) {
@@ -57,46 +57,23 @@ void WayMatrix::buildIndex() {
     }
 
   calculateLadderPoints();
+  invalidatePathCache();
   }
 
 const WayPoint *WayMatrix::findWayPoint(const Vec3& at, const std::function<bool(const WayPoint&)>& filter) const {
-  const WayPoint* ret =nullptr;
-  float           dist=std::numeric_limits<float>::max();
-  for(auto& w:wayPoints) {
-    if(!filter(w))
-      continue;
-    auto  dp0 = at-w.position();
-    float l0  = dp0.quadLength();
-
-    if(l0<dist){
-      ret  = &w;
-      dist = l0;
-      }
-    }
-  return ret;
+  return wayGrid.findNearest(at,std::numeric_limits<float>::max(),filter);
   }
 
 const WayPoint *WayMatrix::findFreePoint(const Vec3& at, std::string_view name, const std::function<bool(const WayPoint&)>& filter) const {
   auto&  index = findFpIndex(name);
-  return findFreePoint(at.x,at.y,at.z,index,filter);
+  return findFreePoint(at,index,filter);
   }
 
 const WayPoint *WayMatrix::findNextPoint(const Vec3& at) const {
-  const WayPoint* ret   = nullptr;
-  float           dist  = distanceThreshold;
-
-  dist*=dist;
-  for(auto pw:indexPoints){
-    auto& w  = *pw;
-    auto  dp = w.position()-at;
-    float l  = dp.quadLength();
-
-    if(l<dist && dp.z*dp.z<300*300 && !w.isLocked()){
-      ret  = &w;
-      dist = l;
-      }
-    }
-  return ret;
+  return indexGrid.findNearest(at,distanceThreshold,[&at](const WayPoint& w){
+    float dz = w.z-at.z;
+    return dz*dz<300*300 && !w.isLocked();
+    });
   }
 
 void WayMatrix::addFreePoint(const Vec3& pos, const Vec3& dir, std::string_view name) {
@@ -184,10 +161,16 @@ void WayMatrix::marchPoints(DbgPainter &p) const {
   }
 
 void WayMatrix::adjustWaypoints(std::vector<WayPoint> &wp) {
-  for(auto& w:wp) {
-    auto ray = world.physic()->landRay(w.position());
-    if(ray.hasCol)
-      w.y = ray.v.y;
+  std::vector<Vec3>                        pos(wp.size());
+  std::vector<DynamicWorld::RayLandResult> ray(wp.size());
+  for(size_t i=0; i<wp.size(); ++i)
+    pos[i] = wp[i].position();
+  world.physic()->landRayBatch(pos,ray);
+
+  for(size_t i=0; i<wp.size(); ++i) {
+    auto& w = wp[i];
+    if(ray[i].hasCol)
+      w.y = ray[i].v.y;
     indexPoints.push_back(&w);
     }
   }
@@ -237,57 +220,57 @@ const WayMatrix::FpIndex &WayMatrix::findFpIndex(std::string_view name) const {
     return *it;
     }
 
-  FpIndex id;
-  id.key = name;
+  std::vector<const WayPoint*> pt;
   for(auto& w:freePoints){
     if(!w.checkName(name))
       continue;
-    id.index.push_back(&w);
+    pt.push_back(&w);
     }
-  // TODO: good index, not sort by 'x' :)
-  std::sort(id.index.begin(),id.index.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->x<b->x;
-    });
 
+  FpIndex id;
+  id.key = name;
+  id.index.build(pt);
   it = fpIndex.insert(it,std::move(id));
   return *it;
   }
 
-const WayPoint *WayMatrix::findFreePoint(float x, float y, float z, const FpIndex& ind,
+const WayPoint *WayMatrix::findFreePoint(const Vec3& at, const FpIndex& ind,
                                          const std::function<bool(const WayPoint&)>& filter) const {
-  float R = distanceThreshold;
-  auto b = std::lower_bound(ind.index.begin(),ind.index.end(), x-R ,[](const WayPoint *a, float b){
-    return a->x<b;
-    });
-  auto e = std::upper_bound(ind.index.begin(),ind.index.end(), x+R ,[](float a,const WayPoint *b){
-    return a<b->x;
+  return ind.index.findNearest(at,distanceThreshold,[&](const WayPoint& w){
+    float dz = w.z-at.z;
+    if(dz*dz>300*300)
+      return false;
+    return filter(w);
     });
+  }
 
-  const WayPoint* ret=nullptr;
-  auto  count = std::distance(b,e);(void) count;
-  float dist  = R*R;
-  for(auto i=b;i!=e;++i){
-    auto& w  = **i;
-    float dx = w.x-x;
-    float dy = w.y-y;
-    float dz = w.z-z;
-    float l  = dx*dx+dy*dy+dz*dz;
-    if(l>dist || dz*dz>300*300)
-      continue;
-    if(!filter(w))
-      continue;
-    ret  = &w;
-    dist = l;
+uint32_t WayMatrix::wayPointId(const WayPoint* wp) const {
+  if(wayPoints.empty() || wp<wayPoints.data() || wp>=wayPoints.data()+wayPoints.size())
+    return uint32_t(-1);
+  return uint32_t(wp-wayPoints.data());
+  }
+
+void WayMatrix::SearchCtx::reset(size_t size) {
+  gen++;
+  if(nodes.size()!=size || gen==0) {
+    // new world or new cycle
+    nodes.assign(size,Node());
+    gen = 1;
     }
-  return ret;
+  open.clear();
   }
 
 WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const {
+  static thread_local SearchCtx ctx;
+  return wayTo(begin,beginSz,exactBegin,end,ctx);
+  }
+
+WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end,
+                         SearchCtx& ctx) const {
   if(beginSz==0)
     return WayPath();
 
-  intptr_t endId = std::distance<const WayPoint*>(&wayPoints[0],&end);
-  if(endId<0 || size_t(endId)>=wayPoints.size()){
+  if(wayPointId(&end)==uint32_t(-1)) {
     if(end.name.find("FP_")==0) {
       WayPath ret;
       ret.add(end);
@@ -296,75 +279,156 @@ WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::
     return WayPath();
     }
 
-  pathGen++;
-  if(pathGen==1){
-    // new cycle
-    for(auto& i:wayPoints)
-      i.pathGen=0;
+  // routes are cached per start point: search only from starts, that are not in cache yet
+  WayPath                      best;
+  int32_t                      bestL = -1;
+  std::vector<const WayPoint*> miss;
+  auto pick = [&](const WayPoint* from, const WayPath& path, int32_t len) {
+    if(len<0)
+      return;
+    int32_t l = len + int32_t((exactBegin - from->position()).length());
+    if(bestL<0 || l<bestL) {
+      best  = path;
+      bestL = l;
+      }
+    };
+
+  {
+  std::lock_guard<std::mutex> guard(pathCacheSync);
+  for(size_t i=0; i<beginSz; ++i) {
+    if(auto c = findCachedPath(begin[i],end))
+      pick(begin[i],c->path,c->len); else
+      miss.push_back(begin[i]);
     }
+  if(miss.empty())
+    pathStats.hits++; else
+    pathStats.misses++;
+  }
 
-  std::vector<const WayPoint*> *front=&stk[0], *back=&stk[1];
-  stk[0].clear();
-  stk[1].clear();
+  for(auto from:miss) {
+    int32_t len  = -1;
+    WayPath path = findPath(&from,1,exactBegin,end,ctx,len);
+    {
+    std::lock_guard<std::mutex> guard(pathCacheSync);
+    storeCachedPath(from,end,path,len);
+    }
+    pick(from,path,len);
+    }
+  return best;
+  }
 
-  end.pathLen = 0;
-  end.pathGen = pathGen;
-  front->push_back(&end);
+WayMatrix::PathCacheStats WayMatrix::pathCacheStats() const {
+  std::lock_guard<std::mutex> guard(pathCacheSync);
+  return pathStats;
+  }
 
-  while(front->size()>0) {
-    bool done = true;
-    for(size_t i=0; i<beginSz; ++i)
-      if(begin[i]->pathGen!=pathGen) {
-        done = false;
-        break;
-        }
-    if(done)
-      break;
+void WayMatrix::invalidatePathCache() {
+  std::lock_guard<std::mutex> guard(pathCacheSync);
+  pathCache.clear();
+  pathCacheIndex.clear();
+  }
 
-    for(auto& wp:*front) {
-      int32_t l0 = wp->pathLen;
-
-      for(auto i:wp->connections()){
-        auto& w  = *i.point;
-        int32_t l1 = l0+i.len;
-        if(w.pathGen!=pathGen || w.pathLen>l1){
-          w.pathLen = l1;
-          w.pathGen = pathGen;
-          back->push_back(&w);
-          }
-        }
-      }
-    std::swap(front,back);
-    back->clear();
+size_t WayMatrix::PathKeyHash::operator()(const PathKey& k) const {
+  size_t h0 = std::hash<const WayPoint*>()(k.begin);
+  size_t h1 = std::hash<const WayPoint*>()(k.end);
+  return h0 ^ (h1 + 0x9e3779b9 + (h0<<6) + (h0>>2));
+  }
+
+const WayMatrix::CachedPath* WayMatrix::findCachedPath(const WayPoint* begin, const WayPoint& end) const {
+  auto it = pathCacheIndex.find(PathKey{begin,&end});
+  if(it==pathCacheIndex.end())
+    return nullptr;
+  // move to front
+  pathCache.splice(pathCache.begin(),pathCache,it->second);
+  return &pathCache.front();
+  }
+
+void WayMatrix::storeCachedPath(const WayPoint* begin, const WayPoint& end, const WayPath& path, int32_t len) const {
+  const PathKey key = {begin,&end};
+  auto it = pathCacheIndex.find(key);
+  if(it!=pathCacheIndex.end()) {
+    pathCache.splice(pathCache.begin(),pathCache,it->second);
+    pathCache.front().path = path;
+    pathCache.front().len  = len;
+    return;
     }
+  if(pathCache.size()>=PathCacheSize) {
+    pathCacheIndex.erase(pathCache.back().key);
+    pathCache.pop_back();
+    }
+  pathCache.push_front(CachedPath{key,path,len});
+  pathCacheIndex[key] = pathCache.begin();
+  }
+
+WayPath WayMatrix::findPath(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end,
+                            SearchCtx& ctx, int32_t& len) const {
+  const uint32_t endId = wayPointId(&end);
+  len = -1;
+
+  // edge length is rounded down, so heuristic may overestimate by less than 1cm per edge - negligible
+  const Vec3 target = end.position();
+  auto heuristic = [&](uint32_t id) {
+    return int32_t((wayPoints[id].position()-target).length());
+    };
 
-  const WayPoint* first = begin[0];
+  ctx.reset(wayPoints.size());
+  auto& nodes = ctx.nodes;
+  auto& open  = ctx.open;
+
+  // multiple starts: initial cost is distance from npc to the start point
   for(size_t i=0; i<beginSz; ++i) {
-    int32_t iLen = begin[i]->pathLen + int((exactBegin - begin[i]->position()).length());
-    int32_t fLen = first   ->pathLen + int((exactBegin - first   ->position()).length());
-    if(iLen<fLen)
-      first = begin[i];
+    const uint32_t id = wayPointId(begin[i]);
+    if(id==uint32_t(-1))
+      continue;
+    const int32_t g = int32_t((exactBegin - begin[i]->position()).length());
+    auto&         n = nodes[id];
+    if(n.gen==ctx.gen && n.g<=g)
+      continue;
+    n.g      = g;
+    n.parent = id;
+    n.gen    = ctx.gen;
+    n.closed = false;
+    open.push_back({g+heuristic(id),id});
+    std::push_heap(open.begin(),open.end());
     }
 
-  WayPath ret;
-  ret.add(*first);
-  const WayPoint* current = first;
-  while(current!=&end) {
-    int32_t l0 = current->pathLen, l1=l0;
-
-    const WayPoint* next=nullptr;
-    for(auto i:current->connections()){
-      if(i.point->pathGen==pathGen && i.point->pathLen+i.len<=l0 && i.point->pathLen<l1){
-        next = i.point;
-        l1   = i.point->pathLen;
+  while(!open.empty()) {
+    std::pop_heap(open.begin(),open.end());
+    const uint32_t id = open.back().id;
+    open.pop_back();
+
+    auto& n = nodes[id];
+    if(n.closed)
+      continue;
+    n.closed = true;
+
+    if(id==endId) {
+      WayPath  ret;
+      uint32_t first = id;
+      for(uint32_t i=id; ; i=nodes[i].parent) {
+        ret.add(wayPoints[i]);
+        first = i;
+        if(nodes[i].parent==i)
+          break;
         }
+      len = n.g - int32_t((exactBegin - wayPoints[first].position()).length());
+      return ret;
+      }
+
+    for(auto& c:wayPoints[id].connections()) {
+      const uint32_t next = wayPointId(c.point);
+      const int32_t  g    = n.g + c.len;
+      auto&          nx   = nodes[next];
+      if(nx.gen==ctx.gen && nx.g<=g)
+        continue;
+      nx.g      = g;
+      nx.parent = id;
+      nx.gen    = ctx.gen;
+      nx.closed = false;
+      open.push_back({g+heuristic(next),next});
+      std::push_heap(open.begin(),open.end());
       }
-    if(next==nullptr)
-      return WayPath();
-    ret.add(*next);
-    current=next;
     }
 
-  ret.reverse();
-  return ret;
+  return WayPath();
   }
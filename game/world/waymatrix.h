@@ -6,8 +6,12 @@
 #include <phoenix/world/way_net.hh>
 
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include <functional>
+#include <mutex>
 
+#include "waygrid.h"
 #include "waypath.h"
 #include "waypoint.h"
 
@@ -18,6 +22,29 @@ class WayMatrix final {
   public:
     WayMatrix(World& owner,const phoenix::way_net& dat);
 
+    // A* state; one per thread, so paths can be planned concurrently
+    class SearchCtx final {
+      private:
+        struct Node {
+          int32_t  g      = 0;
+          uint32_t parent = 0;
+          uint32_t gen    = 0;
+          bool     closed = false;
+          };
+        struct Open {
+          int32_t  f  = 0;
+          uint32_t id = 0;
+          bool operator < (const Open& o) const { return f>o.f; }
+          };
+        std::vector<Node> nodes;
+        std::vector<Open> open;
+        uint32_t          gen = 0;
+
+        void reset(size_t size);
+
+      friend class WayMatrix;
+      };
+
     const WayPoint* findWayPoint (const Tempest::Vec3& at, const std::function<bool(const WayPoint&)>& filter) const;
     const WayPoint* findFreePoint(const Tempest::Vec3& at, std::string_view name, const std::function<bool(const WayPoint&)>& filter) const;
     const WayPoint* findNextPoint(const Tempest::Vec3& at) const;
@@ -33,6 +60,14 @@ class WayMatrix final {
     void            marchPoints(DbgPainter& p) const;
 
     WayPath         wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const;
+    WayPath         wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end, SearchCtx& ctx) const;
+
+    struct PathCacheStats {
+      uint64_t hits   = 0;
+      uint64_t misses = 0;
+      };
+    PathCacheStats  pathCacheStats() const;
+    void            invalidatePathCache();
 
   private:
     World&                 world;
@@ -44,21 +79,46 @@ class WayMatrix final {
     std::vector<WayPoint>  freePoints, startPoints;
     std::vector<WayPoint*> indexPoints;
 
-    std::vector<WayPoint*> fpInd;
+    WayGrid                wayGrid;   // wayPoints only
+    WayGrid                indexGrid; // wayPoints, freePoints and startPoints
 
     struct FpIndex {
       std::string                  key;
-      std::vector<const WayPoint*> index;
+      WayGrid                      index;
       };
     mutable std::vector<FpIndex>          fpIndex;
 
-    mutable uint16_t                      pathGen=0;
-    mutable std::vector<const WayPoint*>  stk[2];
+    // LRU of found routes: (start, end) -> path
+    struct PathKey {
+      const WayPoint* begin = nullptr;
+      const WayPoint* end   = nullptr;
+      bool operator == (const PathKey& k) const { return begin==k.begin && end==k.end; }
+      };
+    struct PathKeyHash {
+      size_t operator()(const PathKey& k) const;
+      };
+    struct CachedPath {
+      PathKey key;
+      WayPath path;
+      int32_t len = -1; // -1 for 'no path'
+      };
+    static constexpr size_t PathCacheSize = 1024;
+
+    mutable std::mutex                    pathCacheSync;
+    mutable std::list<CachedPath>         pathCache;
+    mutable std::unordered_map<PathKey,std::list<CachedPath>::iterator,PathKeyHash> pathCacheIndex;
+    mutable PathCacheStats                pathStats;
 
     void                   adjustWaypoints(std::vector<WayPoint> &wp);
     void                   calculateLadderPoints();
+    uint32_t               wayPointId(const WayPoint* wp) const;
+
+    WayPath                findPath(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end,
+                                    SearchCtx& ctx, int32_t& len) const;
+    const CachedPath*      findCachedPath(const WayPoint* begin, const WayPoint& end) const;
+    void                   storeCachedPath(const WayPoint* begin, const WayPoint& end, const WayPath& path, int32_t len) const;
 
     const FpIndex&         findFpIndex(std::string_view name) const;
-    const WayPoint*        findFreePoint(float x, float y, float z, const FpIndex &ind,
+    const WayPoint*        findFreePoint(const Tempest::Vec3& at, const FpIndex &ind,
                                          const std::function<bool(const WayPoint&)>& filter) const;
   };
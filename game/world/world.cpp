@@ -1,7 +1,9 @@
 #include "world.h"
 
+#include <chrono>
 #include <functional>
 #include <future>
+#include <unordered_set>
 #include <cctype>
 
 #include <Tempest/Log>
@@ -17,6 +19,7 @@
 #include "game/globaleffects.h"
 #include "game/serialize.h"
 #include "utils/string_frm.h"
+#include "utils/fileext.h"
 #include "gothic.h"
 #include "focus.h"
 #include "resources.h"
@@ -71,24 +74,49 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
     return;
     }
 
+  // NOTE: Workers are not used here: world is loaded from loading-thread
+  using clock = std::chrono::steady_clock;
+  auto toMs = [](clock::duration d) {
+    return uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(d).count());
+    };
+  auto time0 = clock::now();
+  auto stage = [&](const char* name, int progress) {
+    auto time1 = clock::now();
+    Tempest::Log::i("loading: ", name, " - ", toMs(time1-time0), " ms");
+    time0 = time1;
+    loadProgress(progress);
+    };
+
   try {
     auto buf = entry->open();
     auto world = phoenix::world::parse(buf, version().game == 1 ? phoenix::game_version::gothic_1
                                                                 : phoenix::game_version::gothic_2);
-    loadProgress(20);
+    stage("parse zen",20);
     auto& worldMesh = world.world_mesh;
 
+    // independent stages: landscape physics, landscape view and vob-visuals
+    clock::duration dtBvh = {}, dtView = {}, dtVisual = {};
     auto wdynamicFut = std::async(std::launch::async, [&]() {
       Workers::setThreadName("Loading: BVH thread");
-      return std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh));
+      auto t0  = clock::now();
+      auto ret = std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh));
+      dtBvh = clock::now()-t0;
+      return ret;
       });
     auto wviewFut = std::async(std::launch::async, [&]() {
       Workers::setThreadName("Loading: PackedMesh thread");
+      auto t0 = clock::now();
       PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd);
-      return std::unique_ptr<WorldView>(new WorldView(*this,vmesh));
+      auto ret = std::unique_ptr<WorldView>(new WorldView(*this,vmesh));
+      dtView = clock::now()-t0;
+      return ret;
+      });
+    auto prefetchFut = std::async(std::launch::async, [&]() {
+      Workers::setThreadName("Loading: visuals thread");
+      auto t0 = clock::now();
+      Resources::prefetchMeshes(vobVisuals(world.world_vobs));
+      dtVisual = clock::now()-t0;
       });
-
-    loadProgress(30);
 
     {
       bsp.nodes             = std::move(world.world_bsp_tree.nodes);
@@ -96,22 +124,30 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
       bsp.leaf_node_indices = std::move(world.world_bsp_tree.leaf_node_indices);
       bsp.sectorsData.resize(bsp.sectors.size());
       world.world_bsp_tree = phoenix::bsp_tree();
+      buildBspIndex();
     }
-    loadProgress(50);
+    stage("bsp",30);
 
     wview = wviewFut.get();
-    loadProgress(60);
+    stage("landscape view (wait)",45);
 
     wdynamic = wdynamicFut.get();
-    loadProgress(70);
+    stage("landscape physics (wait)",55);
+
+    prefetchFut.get();
+    stage("vob visuals (wait)",70);
+    Tempest::Log::i("loading: landscape view - ",toMs(dtView)," ms, physics - ",toMs(dtBvh)," ms, vob visuals - ",toMs(dtVisual)," ms");
 
     globFx.reset(new GlobalEffects(*this));
     wmatrix.reset(new WayMatrix(*this,world.world_way_net));
+    stage("waynet",75);
+
     for(auto& vob:world.world_vobs)
       wobj.addRoot(vob,startup);
+    stage("vob tree",90);
 
     wmatrix->buildIndex();
-    loadProgress(100);
+    stage("waynet index",100);
     }
   catch(...) {
     Tempest::Log::e("unable to load landscape mesh");
@@ -122,6 +158,26 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
 World::~World() {
   }
 
+std::vector<std::string> World::vobVisuals(const std::vector<std::unique_ptr<phoenix::vob>>& vobs) {
+  // mesh names, as requested later by ObjVisual and MoveTrigger
+  std::unordered_set<std::string> uniq;
+  std::function<void(const std::vector<std::unique_ptr<phoenix::vob>>&)> collect;
+  collect = [&](const std::vector<std::unique_ptr<phoenix::vob>>& vobs) {
+    for(auto& i:vobs) {
+      auto visual = i->visual_name;
+      if(FileExt::hasExt(visual,"3DS") || FileExt::hasExt(visual,"MDS") || FileExt::hasExt(visual,"MMS")) {
+        uniq.insert(std::move(visual));
+        }
+      else if(FileExt::exchangeExt(visual,"ASC","MDL")) {
+        uniq.insert(std::move(visual));
+        }
+      collect(i->children);
+      }
+    };
+  collect(vobs);
+  return std::vector<std::string>(uniq.begin(),uniq.end());
+  }
+
 void World::createPlayer(std::string_view cls) {
   size_t id = script().findSymbolIndex(cls);
   if(id==size_t(-1))
@@ -181,6 +237,8 @@ void World::load(Serialize &fin) {
 
   wobj.load(fin);
   npcPlayer = wobj.findHero();
+  // mob/ladder state is restored from save
+  wmatrix->invalidatePathCache();
   }
 
 void World::save(Serialize &fout) {
@@ -279,6 +337,7 @@ MeshObjects::Mesh World::addDecalView(const phoenix::vob& vob) {
   }
 
 void World::updateAnimation(uint64_t dt) {
+  TickStats::Scope perf(stats,TickStats::S_Animation);
   wobj.updateAnimation(dt);
   }
 
@@ -294,9 +353,20 @@ Npc *World::findNpcByInstance(size_t instance) {
   return wobj.findNpcByInstance(instance);
   }
 
-std::string_view World::roomAt(const Tempest::Vec3& p) {
-  if(bsp.nodes.empty())
+void World::updateNpcInstance(Npc& npc, uint32_t prevSym) {
+  wobj.updateNpcInstance(npc,prevSym);
+  }
+
+std::string_view World::roomAt(const Tempest::Vec3& p) const {
+  const uint32_t id = sectorAt(p);
+  if(id==NoSector)
     return "";
+  return bsp.sectors[id].name;
+  }
+
+uint32_t World::sectorAt(const Tempest::Vec3& p) const {
+  if(bsp.nodes.empty())
+    return NoSector;
 
   const auto* node=&bsp.nodes[0];
 
@@ -313,45 +383,51 @@ std::string_view World::roomAt(const Tempest::Vec3& p) {
   if(node->bbox.min.x <= p.x && p.x <node->bbox.max.x &&
      node->bbox.min.y <= p.y && p.y <node->bbox.max.y &&
      node->bbox.min.z <= p.z && p.z <node->bbox.max.z) {
-    return roomAt(*node);
+    // TODO: portals
+    return bsp.nodeSector[size_t(node-bsp.nodes.data())];
     }
 
-  return "";
+  return NoSector;
+  }
+
+void World::buildBspIndex() {
+  bsp.sectorByName.clear();
+  bsp.sectorByName.reserve(bsp.sectors.size());
+  for(size_t i=0; i<bsp.sectors.size(); ++i)
+    bsp.sectorByName.emplace(bsp.sectors[i].name,uint32_t(i));
+
+  // leaf is owned by sector, only if exactly one sector references it
+  std::vector<uint8_t> refCount(bsp.nodes.size());
+  bsp.nodeSector.assign(bsp.nodes.size(),NoSector);
+  for(size_t i=0; i<bsp.sectors.size(); ++i) {
+    const uint32_t id = findSector(bsp.sectors[i].name);
+    for(auto r:bsp.sectors[i].node_indices) {
+      if(r>=bsp.leaf_node_indices.size())
+        continue;
+      size_t idx = size_t(bsp.leaf_node_indices[r]);
+      if(idx>=bsp.nodes.size())
+        continue;
+      if(refCount[idx]<2)
+        refCount[idx]++;
+      bsp.nodeSector[idx] = (refCount[idx]==1) ? id : NoSector;
+      }
+    }
   }
 
-std::string_view World::roomAt(const phoenix::bsp_node& node) {
-  const std::string* ret=nullptr;
-  size_t       count=0;
-  auto         id = &node-bsp.nodes.data();(void)id;
-
-  for(auto& i:bsp.sectors) {
-    for(auto r:i.node_indices)
-      if(r<bsp.leaf_node_indices.size()){
-        size_t idx = bsp.leaf_node_indices[r];
-        if(idx>=bsp.nodes.size())
-          continue;
-        if(&bsp.nodes[idx]==&node) {
-          ret = &i.name;
-          count++;
-          }
-        }
-    }
-  if(count==1) {
-    // TODO: portals
-    return *ret;
-    }
-  static std::string empty;
-  return empty;
+uint32_t World::findSector(std::string_view tag) const {
+  auto it = bsp.sectorByName.find(tag);
+  if(it==bsp.sectorByName.end())
+    return NoSector;
+  return it->second;
   }
 
 World::BspSector* World::portalAt(std::string_view tag) {
   if(tag.empty())
     return nullptr;
-
-  for(size_t i=0;i<bsp.sectors.size();++i)
-    if(bsp.sectors[i].name==tag)
-      return &bsp.sectorsData[i];
-  return nullptr;
+  const uint32_t id = findSector(tag);
+  if(id==NoSector)
+    return nullptr;
+  return &bsp.sectorsData[id];
   }
 
 void World::scaleTime(uint64_t& dt) {
@@ -362,11 +438,22 @@ void World::tick(uint64_t dt) {
   static bool doTicks=true;
   if(!doTicks)
     return;
+  stats.reset();
+  los.clear();
   wobj.tick(dt,dt);
+  {
+  TickStats::Scope perf(stats,TickStats::S_Physics);
   wdynamic->tick(dt);
+  }
+  {
+  TickStats::Scope perf(stats,TickStats::S_View);
   wview->tick(dt);
-  if(auto pl = player())
+  }
+  if(auto pl = player()) {
+    TickStats::Scope perf(stats,TickStats::S_Sound);
     wsound.tick(*pl);
+    }
+  TickStats::Scope perf(stats,TickStats::S_Effects);
   globFx->tick(dt);
   }
 
@@ -753,6 +840,10 @@ void World::addTrigger(AbstractTrigger* trigger) {
   wobj.addTrigger(trigger);
   }
 
+void World::removeTrigger(AbstractTrigger* trigger) {
+  wobj.removeTrigger(trigger);
+  }
+
 void World::addInteractive(Interactive* inter) {
   wobj.addInteractive(inter);
   }
@@ -924,6 +1015,20 @@ WayPath World::wayTo(const Npc &npc, const WayPoint &end) const {
   return wmatrix->wayTo(wpoint.data(),wpoint.size(),p,end);
   }
 
+WayMatrix::PathCacheStats World::pathCacheStats() const {
+  return wmatrix->pathCacheStats();
+  }
+
+bool World::hasLineOfSight(const Npc& observer, const Tempest::Vec3& from, const Tempest::Vec3& to) const {
+  auto key     = LosCache::mkKey(observer,from,to);
+  bool visible = false;
+  if(los.find(key,visible))
+    return visible;
+  visible = !wdynamic->ray(from,to).hasCol;
+  los.store(key,visible);
+  return visible;
+  }
+
 GameScript &World::script() const {
   return *game.script();
   }
@@ -965,11 +1070,7 @@ int32_t World::guildOfRoom(std::string_view portalName) {
     return -1;
 
   auto name = portalName.substr(b,e-b);
-
-  for(size_t i=0;i<bsp.sectors.size();++i) {
-    auto& s = bsp.sectors[i].name;
-    if(s==name)
-      return bsp.sectorsData[i].guild;
-    }
+  if(auto room=portalAt(name))
+    return room->guild;
   return GIL_NONE;
   }
@@ -5,6 +5,7 @@
 #include <Tempest/Matrix4x4>
 #include <string>
 #include <functional>
+#include <unordered_map>
 
 #include <phoenix/world.hh>
 
@@ -13,6 +14,8 @@
 #include "graphics/meshobjects.h"
 #include "game/gamescript.h"
 #include "physics/dynamicworld.h"
+#include "utils/tickstats.h"
+#include "loscache.h"
 #include "worldobjects.h"
 #include "worldsound.h"
 #include "waypoint.h"
@@ -30,6 +33,8 @@ class GlobalFx;
 
 class World final {
   public:
+    static constexpr uint32_t NoSector = uint32_t(-1);
+
     World()=delete;
     World(const World&)=delete;
     World(GameSession& game, std::string_view file, bool startup, std::function<void(int)> loadProgress);
@@ -72,11 +77,18 @@ class World final {
     void                 detectItem(const Tempest::Vec3& p, const float r, const std::function<void(Item&)>& f);
 
     WayPath              wayTo(const Npc& pos,const WayPoint& end) const;
+    auto                 pathCacheStats() const -> WayMatrix::PathCacheStats;
+
+    bool                 hasLineOfSight(const Npc& observer, const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    auto                 losStats() const -> LosCache::Stats { return los.stats(); }
+    auto                 pairStats() const -> const WorldObjects::PairStats& { return wobj.pairStats(); }
+    auto                 animStats() const -> const WorldObjects::AnimStats& { return wobj.animStats(); }
 
     WorldView*           view()     const { return wview.get();    }
     WorldSound*          sound()          { return &wsound;        }
     DynamicWorld*        physic()   const { return wdynamic.get(); }
     GlobalEffects*       globalFx() const { return globFx.get();   }
+    TickStats&           tickStats()      { return stats;          }
 
     GameScript&          script()   const;
     GameSession&         gameSession() const { return game; }
@@ -105,7 +117,9 @@ class World final {
     auto                 takeHero() -> std::unique_ptr<Npc>;
     Npc*                 player() const { return npcPlayer; }
     Npc*                 findNpcByInstance(size_t instance);
-    std::string_view     roomAt(const Tempest::Vec3& arr);
+    void                 updateNpcInstance(Npc& npc, uint32_t prevSym);
+    std::string_view     roomAt(const Tempest::Vec3& arr) const;
+    uint32_t             sectorAt(const Tempest::Vec3& arr) const;
 
     void                 scaleTime(uint64_t& dt);
     void                 tick(uint64_t dt);
@@ -168,6 +182,7 @@ class World final {
     Sound                addLandHitEffect  (ItemMaterial src, phoenix::material_group reciver, const Tempest::Matrix4x4& pos);
 
     void                 addTrigger    (AbstractTrigger* trigger);
+    void                 removeTrigger (AbstractTrigger* trigger);
     void                 addInteractive(Interactive* inter);
     void                 addStartPoint (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
     void                 addFreePoint  (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
@@ -191,6 +206,9 @@ class World final {
       std::vector<phoenix::bsp_sector>      sectors;
       std::vector<std::uint64_t>            leaf_node_indices;
       std::vector<BspSector>                sectorsData;
+      // precomputed: bsp-node -> sector (first sector with same name), or NoSector
+      std::vector<uint32_t>                 nodeSector;
+      std::unordered_map<std::string_view,uint32_t> sectorByName;
       } bsp;
 
     Npc*                                  npcPlayer=nullptr;
@@ -201,9 +219,14 @@ class World final {
     WorldSound                            wsound;
     WorldObjects                          wobj;
     std::unique_ptr<Npc>                  lvlInspector;
+    TickStats                             stats;
+    mutable LosCache                      los;
 
-    auto         roomAt(const phoenix::bsp_node &node) -> std::string_view;
     auto         portalAt(std::string_view tag) -> BspSector*;
+    auto         findSector(std::string_view tag) const -> uint32_t;
+    void         buildBspIndex();
+
+    static std::vector<std::string> vobVisuals(const std::vector<std::unique_ptr<phoenix::vob>>& vobs);
 
     void         initScripts(bool firstTime);
 
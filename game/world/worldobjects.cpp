@@ -11,9 +11,11 @@
 #include "world/triggers/triggerworldstart.h"
 #include "world/triggers/abstracttrigger.h"
 #include "world.h"
+#include "graphics/dynamic/frustrum.h"
 #include "utils/workers.h"
 #include "utils/dbgpainter.h"
 #include "gothic.h"
+#include "camera.h"
 
 #include <Tempest/Painter>
 #include <Tempest/Application>
@@ -21,6 +23,9 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cassert>
+
 using namespace Tempest;
 
 int32_t WorldObjects::MobStates::stateByTime(gtime t) const {
@@ -63,6 +68,11 @@ WorldObjects::WorldObjects(World& owner):owner(owner){
   }
 
 WorldObjects::~WorldObjects() {
+  // vobs are going away all together: no need to unregister triggers one by one
+  triggers.clear();
+  triggersZn.clear();
+  triggersTk.clear();
+  triggersByName.clear();
   }
 
 void WorldObjects::load(Serialize &fin) {
@@ -75,14 +85,9 @@ void WorldObjects::load(Serialize &fin) {
   itemArr.clear();
   items.clear();
 
-  uint32_t sz = fin.directorySize("worlds/",fin.worldName(),"/npc/");
-  npcArr.resize(sz);
-  for(size_t i=0; i<sz; ++i)
-    npcArr[i] = std::make_unique<Npc>(owner,size_t(-1),"");
-  for(size_t i=0; i<npcArr.size(); ++i) {
-    npcArr[i]->load(fin,i);
-    }
+  loadNpcs(fin);
 
+  uint32_t sz = 0;
   fin.setEntry("worlds/",fin.worldName(),"/items");
   fin.read(sz);
   for(size_t i=0; i<sz; ++i) {
@@ -116,9 +121,7 @@ void WorldObjects::save(Serialize &fout) {
   fout.setEntry("worlds/",fout.worldName(),"/version");
   fout.write(Serialize::Version::Current);
 
-  for(size_t i=0; i<npcArr.size(); ++i) {
-    npcArr[i]->save(fout,i);
-    }
+  saveNpcs(fout);
 
   fout.setEntry("worlds/",fout.worldName(),"/items");
   uint32_t sz = uint32_t(itemArr.size());
@@ -141,6 +144,79 @@ void WorldObjects::save(Serialize &fout) {
     i.save(fout);
   }
 
+void WorldObjects::loadNpcs(Serialize& fin) {
+  if(fin.version()<47) {
+    // legacy layout: entry per npc
+    uint32_t sz = fin.directorySize("worlds/",fin.worldName(),"/npc/");
+    npcArr.resize(sz);
+    for(size_t i=0; i<sz; ++i)
+      npcArr[i] = std::make_unique<Npc>(owner,size_t(-1),"");
+    for(size_t i=0; i<npcArr.size(); ++i)
+      npcArr[i]->load(fin,i);
+    reindexNpcs();
+    return;
+    }
+
+  uint32_t count = 0, chunkSize = 0;
+  fin.setEntry("worlds/",fin.worldName(),"/npcTable");
+  fin.read(count,chunkSize);
+  if(count>0 && chunkSize==0)
+    throw std::runtime_error("unable to read npc table");
+
+  npcArr.resize(count);
+  for(size_t i=0; i<count; ++i)
+    npcArr[i] = std::make_unique<Npc>(owner,size_t(-1),"");
+
+  std::vector<uint32_t> offset;
+  for(uint32_t chunk=0; chunk*chunkSize<count; ++chunk) {
+    if(!fin.setEntry("worlds/",fin.worldName(),"/npcChunk/",chunk))
+      throw std::runtime_error("unable to read npc chunk");
+    uint32_t sz = 0;
+    fin.read(sz);
+    if(sz!=std::min(chunkSize,count-chunk*chunkSize))
+      throw std::runtime_error("npc chunk size mismatch");
+    offset.resize(sz);
+    for(auto& i:offset)
+      fin.read(i);
+    for(size_t i=0; i<offset.size(); ++i) {
+      uint32_t len = 0;
+      fin.seekEntry(offset[i]);
+      fin.read(len);
+      npcArr[chunk*chunkSize+i]->loadRecord(fin);
+      if(fin.entryOffset()!=offset[i]+sizeof(len)+len)
+        throw std::runtime_error("npc record size mismatch");
+      }
+    }
+  reindexNpcs();
+  }
+
+void WorldObjects::saveNpcs(Serialize& fout) {
+  // all npc's in few larger entries: record = [length][npc data], entry = [count][offset table][records]
+  const uint32_t count = uint32_t(npcArr.size());
+  fout.setEntry("worlds/",fout.worldName(),"/npcTable");
+  fout.write(count,NpcChunkSize);
+
+  for(uint32_t chunk=0; chunk*NpcChunkSize<count; ++chunk) {
+    const uint32_t begin = chunk*NpcChunkSize;
+    const uint32_t end   = std::min(begin+NpcChunkSize,count);
+
+    fout.setEntry("worlds/",fout.worldName(),"/npcChunk/",chunk);
+    fout.write(end-begin);
+    const size_t table = fout.entryOffset();
+    for(uint32_t i=begin; i<end; ++i)
+      fout.write(uint32_t(0));
+
+    for(uint32_t i=begin; i<end; ++i) {
+      const uint32_t at = uint32_t(fout.entryOffset());
+      fout.writeBytesAt(table+(i-begin)*sizeof(uint32_t),&at,sizeof(at));
+      fout.write(uint32_t(0));
+      npcArr[i]->saveRecord(fout);
+      const uint32_t len = uint32_t(fout.entryOffset()-at-sizeof(uint32_t));
+      fout.writeBytesAt(at,&len,sizeof(len));
+      }
+    }
+  }
+
 void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   auto passive=std::move(sndPerc);
   sndPerc.clear();
@@ -159,11 +235,16 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     std::sort(npcArr.begin(),npcArr.end(),[](std::unique_ptr<Npc>& a, std::unique_ptr<Npc>& b){
       return a->handle().id<b->handle().id;
       });
+    // duplicated instances: table points to first one in npcArr order
+    reindexNpcs();
     }
 
   auto       camera  = Gothic::inst().camera();
   const bool freeCam = (camera!=nullptr && camera->isFree());
   const auto pl      = owner.player();
+  auto&      stats   = owner.tickStats();
+  {
+  TickStats::Scope perf(stats,TickStats::S_NpcAi);
   for(size_t i=0; i<npcArr.size(); ++i) {
     auto& npc = *npcArr[i];
     uint64_t d = (pl==&npc ? dtPlayer : dt);
@@ -171,6 +252,7 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
       continue;
     npc.tick(d);
     }
+  }
 
   for(auto& i:routines) {
     auto s = i.stateByTime(owner.time());
@@ -183,8 +265,11 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   for(auto& i:interactiveObj)
     i->tick(dt);
 
+  {
+  TickStats::Scope perf(stats,TickStats::S_Triggers);
   for(auto i:triggersTk)
     i->tick(dt);
+  }
 
   bullets.remove_if([](Bullet& b){
     return b.isFinished();
@@ -205,9 +290,8 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     return;
 
   npcNear.clear();
-  const int   PERC_DIST_INTERMEDIAT = 1000;
-  const float nearDist              = 3000*3000;
-  const float farDist               = 6000*6000;
+  const float nearDist = 3000*3000;
+  const float farDist  = 6000*6000;
 
   auto plPos = pl->position();
   for(auto& i:npcArr) {
@@ -223,56 +307,119 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
       i->setProcessPolicy(Npc::ProcessPolicy::AiFar2);
       }
     }
+  {
+  TickStats::Scope perf(stats,TickStats::S_Zones);
   tickNear(dt);
   for(CollisionZone* z:collisionZn)
     z->tick(dt);
+  }
+  {
+  TickStats::Scope perf(stats,TickStats::S_Triggers);
   tickTriggers(dt);
+  }
 
-  for(auto& ptr:npcNear) {
-    Npc& i = *ptr;
+  TickStats::Scope perf(stats,TickStats::S_NpcAi);
+
+  // sensing is read-only and thread-safe: compute it in parallel, then run scripts in fixed npc order
+  percGrid.clear();
+  for(size_t id=0; id<passive.size(); ++id)
+    percGrid.insert(uint32_t(id),passive[id].pos);
+  percGrid.build();
+
+  percSense.resize(npcNear.size());
+  for(size_t i=0; i<npcNear.size(); ++i) {
+    percSense[i].npc   = npcNear[i];
+    percSense[i].pairs = 0;
+    }
+  Workers::parallelFor(percSense,[this,pl,&passive](PercSense& s){
+    sensePerceptions(s,*pl,passive);
+    });
+
+  for(auto& s:percSense) {
+    Npc& i = *s.npc;
     if(i.isPlayer() || i.isDead())
       continue;
 
     const uint64_t percNextTime = i.percNextTime();
     if(percNextTime<=owner.tickCount()) {
-      i.perceptionProcess(*pl);
+      i.perceptionProcess(*pl,s.seePlayer);
+      }
+
+    if(i.processPolicy()!=Npc::AiNormal)
+      continue;
+
+    const bool ready = isPassiveReady(i);
+    if(!ready)
+      continue;
+    if(!s.ready) {
+      // state was changed by player-perception script: fall back to serial sensing
+      sensePerceptions(s,*pl,passive);
       }
 
-    if(i.processPolicy()==Npc::AiNormal) {
-      for(auto& r:passive) {
-        if(r.self==&i)
-          continue;
+    for(auto id:s.passive) {
+      auto&       r = passive[id];
+      const float l = i.qDistTo(r.pos.x,r.pos.y,r.pos.z);
+      if(r.item!=size_t(-1) && r.other!=nullptr)
+        owner.script().setInstanceItem(*r.other,r.item);
+      i.perceptionProcess(*r.other,r.victum,l,PercType(r.what));
+      if(!isPassiveReady(i))
+        break;
+      }
+    }
 
-        const float l     = i.qDistTo(r.pos.x,r.pos.y,r.pos.z);
-        const float range = float(std::min(i.handle().senses_range,PERC_DIST_INTERMEDIAT));
-        if(l>range*range)
-          continue;
+  for(auto& s:percSense)
+    pairs.perceptions += s.pairs;
+  }
 
-        if(i.isDown() || i.isPlayer() || !i.isAiQueueEmpty())
-          continue;
+void WorldObjects::sensePerceptions(PercSense& s, const Npc& pl, const std::vector<PerceptionMsg>& passive) const {
+  Npc& i = *s.npc;
 
-        if((percNextTime>owner.tickCount()) &&
-           (r.what==PERC_ASSESSFIGHTSOUND || r.what==PERC_ASSESSQUIETSOUND)) {
-          //Log::d("");
-          //continue;
-          }
+  s.seePlayer = false;
+  s.ready     = false;
+  s.passive.clear();
 
-        if(r.other==nullptr)
-          continue;
+  if(i.isPlayer() || i.isDead())
+    return;
 
-        if(i.canSenseNpc(*r.other, true)==SensesBit::SENSE_NONE)
-          continue;
+  if(i.percNextTime()<=owner.tickCount() && i.processPolicy()==Npc::AiNormal)
+    s.seePlayer = i.canAssessPlayer(pl);
 
-        // approximation of behavior of original G2
-        if(r.victum!=nullptr && i.canSenseNpc(*r.victum,true,float(r.other->handle().senses_range))==SensesBit::SENSE_NONE)
-          continue;
+  if(i.processPolicy()!=Npc::AiNormal)
+    return;
 
-        if(r.item!=size_t(-1) && r.other!=nullptr)
-          owner.script().setInstanceItem(*r.other,r.item);
-        i.perceptionProcess(*r.other,r.victum,l,PercType(r.what));
-        }
-      }
-    }
+  s.ready = isPassiveReady(i);
+  if(!s.ready)
+    return;
+
+  const float range = float(std::min(i.handle().senses_range,PercDistIntermediat));
+  percGrid.query(i.position(),range,[&](uint32_t id) {
+    auto& r = passive[id];
+    ++s.pairs;
+    if(r.self==&i)
+      return;
+
+    const float l = i.qDistTo(r.pos.x,r.pos.y,r.pos.z);
+    if(l>range*range)
+      return;
+
+    if(r.other==nullptr)
+      return;
+
+    if(i.canSenseNpc(*r.other, true)==SensesBit::SENSE_NONE)
+      return;
+
+    // approximation of behavior of original G2
+    if(r.victum!=nullptr && i.canSenseNpc(*r.victum,true,float(r.other->handle().senses_range))==SensesBit::SENSE_NONE)
+      return;
+
+    s.passive.push_back(id);
+    });
+  // keep emission order of perceptions
+  std::sort(s.passive.begin(),s.passive.end());
+  }
+
+bool WorldObjects::isPassiveReady(const Npc& npc) {
+  return !(npc.isDown() || npc.isPlayer() || !npc.isAiQueueEmpty());
   }
 
 uint32_t WorldObjects::npcId(const Npc *ptr) const {
@@ -331,6 +478,7 @@ Npc* WorldObjects::addNpc(size_t npcInstance, std::string_view at) {
     npc->attachToPoint(pos);
     npc->updateTransform();
     npcArr.emplace_back(npc);
+    indexNpc(*npc);
     } else {
     auto& point = owner.deadPoint();
     npc->attachToPoint(nullptr);
@@ -349,6 +497,7 @@ Npc* WorldObjects::addNpc(size_t npcInstance, const Vec3& pos) {
   npc->updateTransform();
 
   npcArr.emplace_back(npc);
+  indexNpc(*npc);
   return npc;
   }
 
@@ -370,6 +519,7 @@ Npc* WorldObjects::insertPlayer(std::unique_ptr<Npc> &&npc, std::string_view at)
   npc->attachToPoint(pos);
   npc->updateTransform();
   npcArr.emplace_back(std::move(npc));
+  indexNpc(*npcArr.back());
   return npcArr.back().get();
   }
 
@@ -380,6 +530,8 @@ std::unique_ptr<Npc> WorldObjects::takeNpc(const Npc* ptr) {
       auto ret=std::move(npcArr[i]);
       npcArr[i] = std::move(npcArr.back());
       npcArr.pop_back();
+      unindexNpc(*ret,ret->instanceSymbol());
+      assert(verifyNpcIndex());
       return ret;
       }
     }
@@ -387,11 +539,29 @@ std::unique_ptr<Npc> WorldObjects::takeNpc(const Npc* ptr) {
   }
 
 void WorldObjects::tickNear(uint64_t /*dt*/) {
+  zoneGrid.clear();
+  for(size_t id=0; id<collisionZn.size(); ++id)
+    zoneGrid.insert(uint32_t(id),collisionZn[id]->position(),collisionZn[id]->extents());
+  zoneGrid.build();
+
+  auto& cand = zoneCandidates;
   for(Npc* i:npcNear) {
     auto pos = i->position() + Vec3(0,i->translateY(),0);
-    for(CollisionZone* z:collisionZn)
+    cand.clear();
+    zoneGrid.query(pos,0,[&cand](uint32_t id){
+      cand.push_back(id);
+      });
+    std::sort(cand.begin(),cand.end());
+    cand.erase(std::unique(cand.begin(),cand.end()),cand.end());
+    pairs.zones += cand.size();
+
+    for(auto id:cand) {
+      if(id>=collisionZn.size())
+        continue;
+      CollisionZone* z = collisionZn[id];
       if(z->checkPos(pos))
         z->onIntersect(*i);
+      }
     }
   }
 
@@ -408,15 +578,15 @@ void WorldObjects::triggerEvent(const TriggerEvent &e) {
   }
 
 bool WorldObjects::execTriggerEvent(const TriggerEvent& e) {
+  auto it = triggersByName.find(e.target);
+  if(it==triggersByName.end())
+    return false;
+  // NOTE: trigger name is not unique - more then one trigger can be activated
   bool emitted=false;
-  for(auto& i:triggers) {
-    auto& t = *i;
-    if(t.name()==e.target) { // NOTE: trigger name is not unique - more then one trigger can be activated
-      t.processEvent(e);
-      emitted=true;
-      }
+  for(auto i:it->second) {
+    i->processEvent(e);
+    emitted=true;
     }
-
   return emitted;
   }
 
@@ -426,14 +596,68 @@ void WorldObjects::updateAnimation(uint64_t dt) {
     return;
   if(dt==0)
     return;
-  Workers::parallelTasks(npcArr,[dt](std::unique_ptr<Npc>& i){
-    i->updateAnimation(dt);
+  updateAnimLod();
+  Workers::parallelTasks(npcArr.size(),[this,dt](uintptr_t i){
+    npcArr[i]->updateAnimation(dt,animSample[i]!=0);
     });
   interactiveObj.parallelFor([dt](Interactive& i){
     i.updateAnimation(dt);
     });
   }
 
+void WorldObjects::updateAnimLod() {
+  // sfx, pfx and events are processed every frame: only sampling of local pose is throttled
+  const float lodNear = Gothic::settingsGetF("INTERNAL","animLodNear");
+  const float lodFar  = Gothic::settingsGetF("INTERNAL","animLodFar");
+  auto        camera  = Gothic::inst().camera();
+  const bool  useLod  = camera!=nullptr && lodNear>0;
+
+  Frustrum f;
+  Vec3     origin;
+  if(useLod) {
+    f.make(camera->viewProj(),1,1);
+    origin = camera->originLwc();
+    }
+
+  animSample.resize(npcArr.size());
+  animStat = AnimStats();
+  animFrame++;
+
+  for(size_t i=0; i<npcArr.size(); ++i) {
+    auto&   npc  = *npcArr[i];
+    AnimLod lod  = ANIM_Full;
+    if(useLod && !npc.isPlayer()) {
+      auto  b    = npc.bounds();
+      float dist = (b.midTr-origin).length() - b.r;
+      if(dist<lodNear)
+        lod = ANIM_Full;
+      else if(!f.testPoint(b.midTr,b.r))
+        lod = ANIM_Frozen;
+      else if(dist<lodFar)
+        lod = ANIM_Half;
+      else
+        lod = ANIM_Quarter;
+      }
+
+    bool sample = false;
+    switch(lod) {
+      case ANIM_Full:    sample = true;                   break;
+      case ANIM_Half:    sample = (animFrame+i)%2==0;     break;
+      case ANIM_Quarter: sample = (animFrame+i)%4==0;     break;
+      case ANIM_Frozen:  sample = false;                  break;
+      case ANIM_Count:   break;
+      }
+    // pose, that just came on screen, must not wait for its turn
+    // previous tier is kept in npc: npcArr is reordered on removal
+    if(npc.animLod()==ANIM_Frozen && lod!=ANIM_Frozen)
+      sample = true;
+
+    npc.setAnimLod(lod);
+    animSample[i] = sample ? 1 : 0;
+    animStat.npc[lod]++;
+    }
+  }
+
 bool WorldObjects::isTargeted(Npc& dst) {
   std::atomic_flag flg = ATOMIC_FLAG_INIT;
   Workers::parallelFor(npcArr,[&dst,&flg](std::unique_ptr<Npc>& i) {
@@ -462,12 +686,66 @@ Npc *WorldObjects::findHero() {
   }
 
 Npc *WorldObjects::findNpcByInstance(size_t instance) {
-  for(auto& i:npcArr)
-    if(i->handle().symbol_index()==instance)
-      return i.get();
+  if(instance<npcBySymbol.size())
+    return npcBySymbol[instance];
   return nullptr;
   }
 
+void WorldObjects::indexNpc(Npc& npc) {
+  const uint32_t sym = npc.instanceSymbol();
+  if(sym==uint32_t(-1))
+    return;
+  if(sym>=npcBySymbol.size())
+    npcBySymbol.resize(sym+1,nullptr);
+  // instance is spawned multiple times: keep already indexed one
+  if(npcBySymbol[sym]==nullptr)
+    npcBySymbol[sym] = &npc;
+  }
+
+void WorldObjects::unindexNpc(const Npc& npc, uint32_t sym) {
+  if(sym>=npcBySymbol.size() || npcBySymbol[sym]!=&npc)
+    return;
+  npcBySymbol[sym] = nullptr;
+  for(auto& i:npcArr)
+    if(i.get()!=&npc && i->instanceSymbol()==sym) {
+      npcBySymbol[sym] = i.get();
+      break;
+      }
+  }
+
+void WorldObjects::updateNpcInstance(Npc& npc, uint32_t prevSym) {
+  // transform-spell changes instance of npc in place
+  unindexNpc(npc,prevSym);
+  if(std::any_of(npcArr.begin(),npcArr.end(),[&npc](const std::unique_ptr<Npc>& i){ return i.get()==&npc; }))
+    indexNpc(npc);
+  assert(verifyNpcIndex());
+  }
+
+void WorldObjects::reindexNpcs() {
+  npcBySymbol.clear();
+  for(auto& i:npcArr)
+    indexNpc(*i);
+  assert(verifyNpcIndex());
+  }
+
+bool WorldObjects::verifyNpcIndex() const {
+  for(size_t sym=0; sym<npcBySymbol.size(); ++sym) {
+    auto npc = npcBySymbol[sym];
+    if(npc==nullptr)
+      continue;
+    if(npc->instanceSymbol()!=sym)
+      return false;
+    if(std::none_of(npcArr.begin(),npcArr.end(),[npc](const std::unique_ptr<Npc>& i){ return i.get()==npc; }))
+      return false;
+    }
+  for(auto& i:npcArr) {
+    const uint32_t sym = i->instanceSymbol();
+    if(sym!=uint32_t(-1) && (sym>=npcBySymbol.size() || npcBySymbol[sym]==nullptr))
+      return false;
+    }
+  return true;
+  }
+
 void WorldObjects::detectNpcNear(const std::function<void(Npc&)>& f) {
   for(auto& i:npcNear)
     f(*i);
@@ -485,18 +763,38 @@ void WorldObjects::detectNpc(const float x, const float y, const float z,
 
 void WorldObjects::detectItem(const float x, const float y, const float z,
                               const float r, const std::function<void(Item&)>& f) {
-  float maxDist=r*r;
-  for(auto& i:itemArr) {
-    auto qDist = (i->position()-Vec3(x,y,z)).quadLength();
+  const Vec3  pos     = Vec3(x,y,z);
+  const float maxDist = r*r;
+  items.find(pos,r,[&pos,maxDist,&f](Item& i) {
+    auto qDist = (i.position()-pos).quadLength();
     if(qDist<maxDist)
-      f(*i);
-    }
+      f(i);
+    });
   }
 
 void WorldObjects::addTrigger(AbstractTrigger* tg) {
   if(tg->hasVolume())
     triggersZn.emplace_back(tg);
   triggers.emplace_back(tg);
+  triggersByName[std::string(tg->name())].push_back(tg);
+  }
+
+void WorldObjects::removeTrigger(AbstractTrigger* tg) {
+  auto rm = [tg](std::vector<AbstractTrigger*>& v) {
+    auto it = std::find(v.begin(),v.end(),tg);
+    if(it!=v.end())
+      v.erase(it);
+    };
+  rm(triggers);
+  rm(triggersZn);
+  rm(triggersTk);
+
+  auto it = triggersByName.find(std::string(tg->name()));
+  if(it==triggersByName.end())
+    return;
+  rm(it->second);
+  if(it->second.empty())
+    triggersByName.erase(it);
   }
 
 bool WorldObjects::triggerOnStart(bool firstTime) {
@@ -727,18 +1025,7 @@ Interactive* WorldObjects::findInteractive(const Npc &pl, Interactive* def, cons
     return def;
   if(owner.view()==nullptr)
     return nullptr;
-
-  Interactive* ret  = nullptr;
-  float        rlen = opt.rangeMax*opt.rangeMax;
-  interactiveObj.find(pl.position(),opt.rangeMax,[&](Interactive& n){
-    float nlen = rlen;
-    if(testObj(n,pl,opt,nlen)){
-      rlen = nlen;
-      ret  = &n;
-      }
-    return false;
-    });
-  return ret;
+  return findNearestObj(interactiveObj,pl,opt);
   }
 
 Npc* WorldObjects::findNpcNear(const Npc& pl, Npc* def, const SearchOpt& opt) {
@@ -762,18 +1049,7 @@ Item *WorldObjects::findItem(const Npc &pl, Item *def, const SearchOpt& opt) {
     return def;
   if(owner.view()==nullptr)
     return nullptr;
-
-  Item* ret  = nullptr;
-  float rlen = opt.rangeMax*opt.rangeMax;
-  items.find(pl.position(),opt.rangeMax,[&](Item& n){
-    float nlen = rlen;
-    if(testObj(n,pl,opt,nlen)){
-      rlen = nlen;
-      ret  = &n;
-      }
-    return false;
-    });
-  return ret;
+  return findNearestObj(items,pl,opt);
   }
 
 void WorldObjects::marchInteractives(DbgPainter &p) const {
@@ -892,6 +1168,8 @@ void WorldObjects::resetPositionToTA() {
       npc.updateTransform();
       }
     }
+  reindexNpcs();
+
   for(auto& i:routines) {
     auto s = i.stateByTime(owner.time());
     i.curState = s;
@@ -974,6 +1252,26 @@ auto WorldObjects::findObj(T &src,const Npc &pl, const SearchOpt& opt) -> typena
   return ret;
   }
 
+template<class T>
+T* WorldObjects::findNearestObj(SpaceIndex<T>& index, const Npc& pl, const SearchOpt& opt) {
+  // test candidates from nearest to farthest: the first one, that passes, is the answer
+  // and visibility ray-tests for the rest are skipped
+  std::vector<std::pair<float,T*>> dist;
+  index.find(pl.position(),opt.rangeMax,[&pl,&dist](T& obj) {
+    dist.emplace_back(pl.qDistTo(obj),&obj);
+    });
+  std::sort(dist.begin(),dist.end(),[](const std::pair<float,T*>& a, const std::pair<float,T*>& b){
+    return a.first<b.first;
+    });
+
+  for(auto& i:dist) {
+    float nlen = opt.rangeMax*opt.rangeMax;
+    if(testObj(*i.second,pl,opt,nlen))
+      return i.second;
+    }
+  return nullptr;
+  }
+
 template<class T>
 bool WorldObjects::testObj(T &src, const Npc &pl, const WorldObjects::SearchOpt &opt) {
   float rlen = opt.rangeMax*opt.rangeMax;
@@ -2,11 +2,13 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 #include <phoenix/vobs/misc.hh>
 
 #include "bullet.h"
 #include "spaceindex.h"
+#include "spatialgrid.h"
 #include "game/gametime.h"
 #include "game/perceptionmsg.h"
 #include "game/constants.h"
@@ -47,9 +49,22 @@ class WorldObjects final {
       SearchFlg     flags       = NoFlg;
       };
 
+    // candidate pairs, tested since world load
+    struct PairStats {
+      uint64_t perceptions = 0;
+      uint64_t zones       = 0;
+      };
+
+    // npc count per animation lod tier, for last frame
+    struct AnimStats {
+      uint32_t npc[ANIM_Count] = {};
+      };
+
     void           load(Serialize& fout);
     void           save(Serialize& fout);
     void           tick(uint64_t dt, uint64_t dtPlayer);
+    auto           pairStats() const -> const PairStats& { return pairs; }
+    auto           animStats() const -> const AnimStats& { return animStat; }
 
     Npc*           addNpc(size_t itemInstance, std::string_view     at);
     Npc*           addNpc(size_t itemInstance, const Tempest::Vec3& at);
@@ -61,6 +76,7 @@ class WorldObjects final {
     bool           isTargeted(Npc& npc);
     Npc*           findHero();
     Npc*           findNpcByInstance(size_t instance);
+    void           updateNpcInstance(Npc& npc, uint32_t prevSym);
     void           detectNpcNear(const std::function<void(Npc&)>& f);
     void           detectNpc (const float x, const float y, const float z, const float r, const std::function<void(Npc&)>&  f);
     void           detectItem(const float x, const float y, const float z, const float r, const std::function<void(Item&)>& f);
@@ -79,6 +95,7 @@ class WorldObjects final {
     uint32_t       mobsiId(const void* ptr) const;
 
     void           addTrigger(AbstractTrigger* trigger);
+    void           removeTrigger(AbstractTrigger* trigger);
     void           triggerEvent(const TriggerEvent& e);
     bool           triggerOnStart(bool firstTime);
     bool           execTriggerEvent(const TriggerEvent& e);
@@ -148,9 +165,29 @@ class WorldObjects final {
       uint64_t timeUntil = 0;
       };
 
+    // npc records per save-game entry
+    static constexpr uint32_t NpcChunkSize = 64;
+
+    // result of read-only sensing pass, applied serially afterwards
+    struct PercSense {
+      Npc*                  npc       = nullptr;
+      bool                  seePlayer = false;
+      bool                  ready     = false;
+      uint32_t              pairs     = 0;
+      std::vector<uint32_t> passive;
+      };
+
+    // max range of passive perceptions
+    static constexpr int PercDistIntermediat = 1000;
+
     World&                             owner;
 
     std::vector<CollisionZone*>        collisionZn;
+    std::vector<AbstractTrigger*>      triggers;
+    std::vector<AbstractTrigger*>      triggersZn;
+    std::vector<AbstractTrigger*>      triggersTk;
+    // NOTE: trigger name is not unique - bucket keeps triggers in order of creation
+    std::unordered_map<std::string,std::vector<AbstractTrigger*>> triggersByName;
     std::vector<std::unique_ptr<Vob>>  rootVobs;
 
     SpaceIndex<Interactive>            interactiveObj;
@@ -165,11 +202,18 @@ class WorldObjects final {
 
     std::vector<std::unique_ptr<Npc>>  npcArr;
     std::vector<std::unique_ptr<Npc>>  npcInvalid;
+    // instance symbol -> npc from npcArr
+    std::vector<Npc*>                  npcBySymbol;
     std::vector<Npc*>                  npcNear;
+    std::vector<PercSense>             percSense;
+    SpatialGrid                        percGrid{float(PercDistIntermediat)};
+    SpatialGrid                        zoneGrid{float(PercDistIntermediat)};
+    std::vector<uint32_t>              zoneCandidates;
+    PairStats                          pairs;
+    std::vector<uint8_t>               animSample;
+    uint32_t                           animFrame = 0;
+    AnimStats                          animStat;
 
-    std::vector<AbstractTrigger*>      triggers;
-    std::vector<AbstractTrigger*>      triggersZn;
-    std::vector<AbstractTrigger*>      triggersTk;
     std::vector<PerceptionMsg>         sndPerc;
     std::vector<TriggerEvent>          triggerEvents;
     CsCamera*                          currentCsCamera = nullptr;
@@ -177,6 +221,9 @@ class WorldObjects final {
     template<class T>
     auto findObj(T &src, const Npc &pl, const SearchOpt& opt) -> typename std::remove_reference<decltype(src[0])>::type;
 
+    template<class T>
+    T*   findNearestObj(SpaceIndex<T>& index, const Npc& pl, const SearchOpt& opt);
+
     template<class T>
     bool testObj(T &src, const Npc &pl, const SearchOpt& opt);
     template<class T>
@@ -184,7 +231,18 @@ class WorldObjects final {
 
     void             setMobState(std::string_view scheme, int32_t st);
 
+    void             loadNpcs(Serialize& fin);
+    void             saveNpcs(Serialize& fout);
+
+    void             indexNpc  (Npc& npc);
+    void             unindexNpc(const Npc& npc, uint32_t sym);
+    void             reindexNpcs();
+    bool             verifyNpcIndex() const;
+
     void             tickNear(uint64_t dt);
+    void             sensePerceptions(PercSense& s, const Npc& pl, const std::vector<PerceptionMsg>& passive) const;
+    static bool      isPassiveReady(const Npc& npc);
     void             tickTriggers(uint64_t dt);
+    void             updateAnimLod();
     static bool      isTargetedBy(Npc& npc,Npc& by);
   };
@@ -199,10 +199,13 @@ void WorldSound::tick(Npc& player) {
       i.active = false;
     }
 
+  occSlot.clear();
+  occQuery.clear();
   tickSlot(effect);
   tickSlot(effect3d);
   for(auto& i:freeSlot)
     tickSlot(*i.second);
+  tickOcclusion();
   tickSoundZone(player);
   }
 
@@ -296,18 +299,25 @@ void WorldSound::tickSlot(Effect& slot) {
 
   if(slot.ambient) {
     slot.setOcclusion(1.f);
+    return;
+    }
+
+  if((slot.pos-plPos).quadLength()<slot.maxDist*slot.maxDist) {
+    // resolved in tickOcclusion
+    occSlot.push_back(&slot);
+    occQuery.push_back({plPos,slot.pos});
     } else {
-    auto  dyn  = owner.physic();
-    auto  head = plPos;
-    auto  pos  = slot.pos;
-    float occ  = 1;
-
-    if((pos-head).quadLength()<slot.maxDist*slot.maxDist)
-      occ = dyn->soundOclusion(head, pos);
-    slot.setOcclusion(std::max(0.f,1.f-occ));
+    slot.setOcclusion(0.f);
     }
   }
 
+void WorldSound::tickOcclusion() {
+  occResult.resize(occQuery.size());
+  owner.physic()->soundOclusionBatch(occQuery,occResult);
+  for(size_t i=0; i<occSlot.size(); ++i)
+    occSlot[i]->setOcclusion(std::max(0.f,1.f-occResult[i]));
+  }
+
 void WorldSound::initSlot(WorldSound::Effect& slot) {
   auto  dyn = owner.physic();
   auto  pos = slot.pos;
@@ -9,6 +9,7 @@
 
 #include <mutex>
 
+#include "physics/dynamicworld.h"
 #include "gamemusic.h"
 
 class GameSession;
@@ -62,6 +63,7 @@ class WorldSound final {
     void    tickSoundZone(Npc& player);
     void    tickSlot(std::vector<PEffect>& eff);
     void    tickSlot(Effect& slot);
+    void    tickOcclusion();
     void    initSlot(Effect& slot);
     bool    setMusic(std::string_view zone, GameMusic::Tags tags);
 
@@ -85,6 +87,10 @@ class WorldSound final {
     std::vector<PEffect>                    effect3d; // snd_play3d
     std::vector<WSound>                     worldEff;
 
+    std::vector<Effect*>                    occSlot;
+    std::vector<DynamicWorld::RayQuery>     occQuery;
+    std::vector<float>                      occResult;
+
     std::mutex                              sync;
 
     static const float maxDist;